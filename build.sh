@@ -6,6 +6,14 @@ if [ "$1" != "" ]; then
     BuildType="$1"
 fi
 
+# Pass io_uring as the second argument to build with the io_uring backend
+WithIoUring="False"
+IoUringOption="OFF"
+if [ "$2" == "io_uring" ]; then
+    WithIoUring="True"
+    IoUringOption="ON"
+fi
+
 OS=$(uname)
 if [ "$OS" == "Linux" ]; then
     OSProfile="linux"
@@ -17,8 +25,8 @@ else
 fi
 
 ProfilePath="./profiles/${OSProfile}/gcc-x86_64-${BuildType,,}"
-conan install . --profile:build=$ProfilePath --profile:host=$ProfilePath --output-folder=build --build=missing
+conan install . --profile:build=$ProfilePath --profile:host=$ProfilePath --output-folder=build --build=missing -o with_io_uring=$WithIoUring
 
 cd "./build"
-cmake .. -DCMAKE_TOOLCHAIN_FILE="conan_toolchain.cmake" -DCMAKE_BUILD_TYPE=$BuildType
+cmake .. -DCMAKE_TOOLCHAIN_FILE="conan_toolchain.cmake" -DCMAKE_BUILD_TYPE=$BuildType -DUDP_ENABLE_IO_URING=$IoUringOption
 cmake --build . --config $BuildType
@@ -2,12 +2,17 @@ from conan import ConanFile
 
 class UDPConan(ConanFile):
     settings = "os", "compiler", "build_type", "arch"
+    options = {"with_io_uring": [True, False]}
+    default_options = {"with_io_uring": False}
     generators = "CMakeToolchain", "CMakeDeps"
 
     def requirements(self):
         self.requires("boost/1.84.0")
         self.requires("protobuf/3.21.12")
 
+        if self.settings.os == "Linux" and self.options.with_io_uring:
+            self.requires("liburing/2.4")
+
     def configure(self):
         # enabled_modules = ["container", "context", "coroutine", "exception", "system"]
 
@@ -0,0 +1,1545 @@
+#pragma once
+
+#include "client/config.hpp"
+#include "client/landing_buffer.hpp"
+#include "constants.hpp"
+#include "protocol.pb.h"
+#include "utils/checksum.hpp"
+#include "utils/element_type.hpp"
+#include "utils/formatters.hpp"
+#include "utils/logger.hpp"
+#include "utils/messages.hpp"
+#include "utils/radix_sort.hpp"
+#include "utils/rtt_estimator.hpp"
+#include "utils/shared_ring.hpp"
+#include "utils/xor_parity.hpp"
+
+#include <boost/asio/as_tuple.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/experimental/awaitable_operators.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/multicast.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/use_future.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <execution>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace client {
+
+using boost::asio::as_tuple_t;
+using boost::asio::awaitable;
+using boost::asio::co_spawn;
+using boost::asio::use_awaitable_t;
+using boost::asio::ip::udp;
+using default_token = as_tuple_t<use_awaitable_t<>>;
+using udp_socket = default_token::as_default_on_t<udp::socket>;
+using steady_timer = default_token::as_default_on_t<boost::asio::steady_timer>;
+
+using namespace boost::asio::experimental::awaitable_operators;
+using namespace protocol;
+
+// Outcome of one number sequence request
+struct JobResult {
+    uint64_t request_id{};
+    NumberSequenceError error{NumberSequenceError::SEQUENCE_OK};
+    std::string error_message;
+    // Numbers received, zero if the request failed
+    uint64_t number_count{};
+    // Empty if the numbers were kept in process
+    std::filesystem::path numbers_file_path;
+};
+
+// Hand the numbers of the requests to the application as they arrive, on
+// the thread running the io_context. The spans are only valid during the
+// call.
+template <typename NumberType> struct Handlers {
+    // Every sequence as received, in arrival order
+    std::function<void(uint64_t request_id, uint64_t sequence_index,
+                       std::span<const NumberType> numbers)>
+        on_sequence;
+    // Consecutive chunks of the numbers of a request in descending order,
+    // once sorted by the server or by the client
+    std::function<void(uint64_t request_id,
+                       std::span<const NumberType> numbers)>
+        on_sorted;
+};
+
+// The first request writes to the numbers file path, the following ones
+// number the files after it, e.g. numbers.1.bin
+inline std::filesystem::path
+get_numbers_file_path(const std::filesystem::path &numbers_file_path,
+                      uint64_t job_index) {
+    if (job_index == 0 || numbers_file_path.empty()) {
+        return numbers_file_path;
+    }
+
+    return numbers_file_path.parent_path() /
+           std::format("{}.{}{}", numbers_file_path.stem().string(), job_index,
+                       numbers_file_path.extension().string());
+}
+
+// The client is specialised for the element type of the requested numbers,
+// see utils::ElementTraits. Every client owns its socket and session, so
+// several clients may run concurrently on a shared io_context.
+template <typename Traits> class UDPNumberSorterClient {
+public:
+    using NumberType = typename Traits::value_type;
+
+    // An empty numbers file path keeps the numbers in process, they are
+    // then only handed to the handlers
+    UDPNumberSorterClient(boost::asio::io_context &io_context,
+                          client::Config config,
+                          std::filesystem::path numbers_file_path,
+                          utils::Logger &logger,
+                          Handlers<NumberType> handlers = {})
+        : io_context_{io_context},
+          socket_{io_context, udp::endpoint{udp::v4(), 0}},
+          buffer_(MESSAGE_MAX_SIZE, '\0'), config_{std::move(config)},
+          numbers_file_path_{std::move(numbers_file_path)}, logger_{logger},
+          handlers_{std::move(handlers)},
+          rtt_{INITIAL_RETRANSMISSION_TIMEOUT, MIN_RETRANSMISSION_TIMEOUT,
+               MAX_RETRANSMISSION_TIMEOUT},
+          strand_{boost::asio::make_strand(io_context)},
+          shared_memory_readers_timer_{strand_} {
+
+        // Jobs are divided across several servers by client::StripedClient,
+        // this client talks to the first one
+        const auto &server = config_.servers().front();
+        udp::resolver resolver{io_context};
+        endpoint_ = *resolver
+                         .resolve(udp::v4(), server.host,
+                                  std::to_string(server.port))
+                         .begin();
+    }
+
+    // Runs the requests on the io_context, the future becomes ready once
+    // they all finished
+    std::future<std::vector<JobResult>> start() {
+        return co_spawn(io_context_, async_run(), boost::asio::use_future);
+    }
+
+    // Performs the handshake and serves every request of the config.
+    // Completes once all requests have finished or failed, throws if the
+    // server cannot be reached. A client runs only once: its request ids
+    // would repeat on the same session, which the server drops as completed.
+    awaitable<std::vector<JobResult>> async_run() {
+        if (std::exchange(started_, true)) {
+            throw std::runtime_error{"The client has already been run"};
+        }
+
+        co_return co_await co_spawn(strand_, run(),
+                                    boost::asio::use_awaitable);
+    }
+
+private:
+    // Runs on the strand, which the coroutines reading shared memory share
+    // with it when the io_context has several threads
+    awaitable<std::vector<JobResult>> run() {
+        const auto version_response = co_await perform_handshake();
+        if (!version_response) {
+            throw std::runtime_error{"Server is unreachable"};
+        }
+
+        if (version_response->error() != ProtocolVersionError::VERSION_OK) {
+            throw std::runtime_error{std::format(
+                "Protocol version requirement is not met: {}",
+                version_response->error_message())};
+        }
+
+        session_token_ = version_response->session_token();
+        shared_memory_ = version_response->shared_memory();
+        init_jobs();
+
+        if (shared_memory_) {
+            logger_.log("Reading number sequences from shared memory");
+            shared_memory_waiter_.emplace(jobs_.size());
+        }
+
+        if (config_.multicast()) {
+            co_await receive_multicast_number_sequences();
+        } else {
+            // The readers refer to the jobs, they are stopped before the
+            // jobs go away whatever ended the run
+            std::exception_ptr error;
+
+            try {
+                co_await receive_number_sequences();
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            co_await stop_shared_memory_readers();
+
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        std::vector<JobResult> results;
+        results.reserve(jobs_.size());
+
+        for (const auto &job : jobs_) {
+            results.push_back(job.result);
+        }
+
+        co_return results;
+    }
+
+    // One number sequence request pipelined on the session, together with
+    // the numbers received for it. The request id is the index of the job.
+    struct Job {
+        NumberSequenceRequest request;
+        std::filesystem::path numbers_file_path;
+        std::ofstream numbers_file;
+        std::vector<std::vector<NumberType>> number_sequences;
+        // Used instead of number_sequences if enabled, every sequence but
+        // the last holds sequence_capacity numbers
+        client::LandingBuffer<NumberType> landing_buffer;
+        uint64_t sequence_capacity{};
+        // The number sequence request itself or the latest acknowledgement
+        Request last_request;
+        std::chrono::steady_clock::time_point send_time;
+        uint64_t next_sequence_index{0};
+        std::optional<uint64_t> sequence_count;
+        bool retransmitted{false};
+        bool finished{false};
+        // Set once subscribed to a multicast stream, whose sequences arrive
+        // in any order. next_sequence_index then follows the highest
+        // sequence received.
+        std::optional<uint64_t> stream_id;
+        std::vector<bool> received_sequences;
+        uint64_t received_count{0};
+        // The request is not repeated before, as hinted by an overloaded
+        // server
+        std::chrono::steady_clock::time_point retry_time;
+        // Sorted sequences of a multicast stream arriving ahead of their
+        // predecessors, by sequence index
+        std::map<uint64_t, std::vector<NumberType>> pending_sequences;
+        uint64_t next_sorted_index{0};
+        // With forward error correction, the sequences of the group starting
+        // at next_sequence_index are held until the group is complete
+        std::vector<std::optional<NumberSequenceResponse>> group_responses;
+        std::optional<NumberSequenceParityResponse> group_parity;
+        // Set once the server writes the sequences to shared memory, which
+        // are read by their own coroutine sending through its own buffer
+        std::shared_ptr<utils::SharedRing> shared_ring;
+        std::string buffer;
+        JobResult result;
+    };
+
+    // Retries the protocol version request with exponential backoff, so the
+    // transfer starts as soon as the server becomes reachable.
+    awaitable<std::optional<ProtocolVersionResponse>> perform_handshake() {
+        const auto version_request =
+            utils::make_request(create_protocol_version_request());
+        steady_timer::duration timeout{HANDSHAKE_INITIAL_TIMEOUT};
+
+        for (uint8_t retry_index{0}; retry_index <= HANDSHAKE_MAX_RETRIES_COUNT;
+             ++retry_index) {
+            const auto send_time = std::chrono::steady_clock::now();
+            co_await send_request(version_request);
+
+            const auto version_response =
+                co_await receive_response<ProtocolVersionResponse>(timeout);
+
+            if (version_response) {
+                if (retry_index == 0) {
+                    rtt_.add_sample(std::chrono::steady_clock::now() -
+                                    send_time);
+                }
+
+                if (version_response->error() !=
+                    ProtocolVersionError::VERSION_OK) {
+                    logger_.log("Protocol version requirement is not met. "
+                                "Server protocol version: {}. Error: {}",
+                                version_response->protocol_version(),
+                                version_response->error_message());
+                }
+
+                co_return version_response;
+            }
+
+            logger_.log(
+                "Server did not respond to protocol version request within "
+                "{}. Retry: {}",
+                std::chrono::duration_cast<std::chrono::milliseconds>(timeout),
+                retry_index);
+            timeout = std::min<steady_timer::duration>(
+                timeout * 2, MAX_RETRANSMISSION_TIMEOUT);
+        }
+
+        logger_.log("Server is unreachable");
+        co_return std::nullopt;
+    }
+
+    // Sends the number sequence requests of all jobs at once and
+    // acknowledges each sequence received, or each group of sequences with
+    // forward error correction. While the server is silent, the last request
+    // of every unfinished job is retransmitted. Jobs read from shared memory
+    // are finished by their own coroutines.
+    awaitable<void> receive_number_sequences() {
+        for (auto &job : jobs_) {
+            job.send_time = std::chrono::steady_clock::now();
+            co_await send_request(job.last_request);
+        }
+
+        uint8_t retry_index{0};
+
+        while (const auto unfinished_job_count = count_unfinished_jobs()) {
+            if (shared_memory_error_) {
+                std::rethrow_exception(shared_memory_error_);
+            }
+
+            steady_timer timer{socket_.get_executor(), rtt_.timeout()};
+            const auto response = co_await receive_response(timer);
+
+            if (!response) {
+                const auto now = std::chrono::steady_clock::now();
+                if (!are_jobs_deferred(now)) {
+                    handle_timeout(retry_index, unfinished_job_count);
+                }
+
+                for (auto &job : jobs_) {
+                    if (!job.finished && !job.shared_ring &&
+                        job.retry_time <= now) {
+                        job.retransmitted = true;
+                        co_await send_request(job.last_request);
+                    }
+                }
+
+                continue;
+            }
+
+            if (const auto *parity_response =
+                    utils::get_payload<NumberSequenceParityResponse>(
+                        *response)) {
+                if (parity_response->request_id() < jobs_.size()) {
+                    retry_index = 0;
+                    co_await receive_group_parity(
+                        jobs_[parity_response->request_id()],
+                        *parity_response);
+                }
+
+                continue;
+            }
+
+            if (const auto *shared_memory_response =
+                    utils::get_payload<SharedMemoryResponse>(*response)) {
+                if (shared_memory_response->request_id() < jobs_.size()) {
+                    retry_index = 0;
+                    co_await receive_shared_memory_response(
+                        jobs_[shared_memory_response->request_id()],
+                        *shared_memory_response);
+                }
+
+                continue;
+            }
+
+            const auto *sequence_response =
+                utils::get_payload<NumberSequenceResponse>(*response);
+            if (!sequence_response ||
+                sequence_response->request_id() >= jobs_.size()) {
+                continue;
+            }
+
+            auto &job = jobs_[sequence_response->request_id()];
+            retry_index = 0;
+
+            if (sequence_response->error() !=
+                NumberSequenceError::SEQUENCE_OK) {
+                if (!defer_job(job, *sequence_response) && !job.finished) {
+                    fail_job(job, *sequence_response);
+                }
+
+                continue;
+            }
+
+            if (sequence_response->fec_group_size() != 0) {
+                co_await receive_group_sequence(job, *sequence_response);
+                continue;
+            }
+
+            if (sequence_response->sequence_index() > job.next_sequence_index) {
+                continue;
+            }
+
+            const auto ack_request =
+                create_number_sequence_ack_request(*sequence_response);
+
+            // Earlier sequences are retransmissions caused by a lost
+            // acknowledgement, they are only acknowledged again. This
+            // includes the last sequence of a finished job.
+            if (sequence_response->sequence_index() ==
+                job.next_sequence_index) {
+                if (!job.retransmitted) {
+                    rtt_.add_sample(std::chrono::steady_clock::now() -
+                                    job.send_time);
+                }
+
+                if (ack_request.ack() == NumberSequenceAck::ACK_OK) {
+                    if (!job.sequence_count) {
+                        job.sequence_count =
+                            sequence_response->sequence_count();
+                        init_number_sequences(job, *sequence_response);
+                    }
+
+                    process_number_sequence_response(job, *sequence_response);
+
+                    if (++job.next_sequence_index == *job.sequence_count) {
+                        finish_job(job);
+                    }
+                } else {
+                    logger_.log(
+                        "Failed to acknowledge number sequence {} of request "
+                        "{}. Expected checksum: {}. Actual checksum: {}",
+                        sequence_response->sequence_index(),
+                        sequence_response->request_id(),
+                        sequence_response->checksum(), ack_request.checksum());
+                }
+
+                job.retransmitted = false;
+            } else {
+                job.retransmitted = true;
+            }
+
+            job.last_request = utils::make_request(ack_request);
+            job.send_time = std::chrono::steady_clock::now();
+            co_await send_request(job.last_request);
+        }
+    }
+
+    // Sequences of a group are held until the group is complete. Those of a
+    // group already acknowledged are retransmissions caused by a lost
+    // acknowledgement, which is sent again.
+    awaitable<void>
+    receive_group_sequence(Job &job, const NumberSequenceResponse &response) {
+        const auto sequence_index = response.sequence_index();
+        const auto group_size = response.fec_group_size();
+
+        if (sequence_index < job.next_sequence_index) {
+            job.retransmitted = true;
+            const auto first_sequence_index =
+                sequence_index - sequence_index % group_size;
+            co_await send_request(utils::make_request(
+                create_group_ack_request(job, first_sequence_index)));
+            co_return;
+        }
+
+        if (job.finished ||
+            sequence_index - job.next_sequence_index >= group_size) {
+            co_return;
+        }
+
+        const auto checksum =
+            utils::calculate_checksum(Traits::numbers(response));
+        if (checksum != response.checksum()) {
+            logger_.log("Dropping number sequence {} of request {}. Expected "
+                        "checksum: {}. Actual checksum: {}",
+                        sequence_index, response.request_id(),
+                        response.checksum(), checksum);
+            co_return;
+        }
+
+        if (job.group_responses.empty()) {
+            if (!job.retransmitted) {
+                rtt_.add_sample(std::chrono::steady_clock::now() -
+                                job.send_time);
+            }
+
+            job.group_responses.resize(
+                std::min<uint64_t>(group_size, response.sequence_count() -
+                                                   job.next_sequence_index));
+        }
+
+        job.group_responses[sequence_index - job.next_sequence_index] =
+            response;
+        co_await complete_group(job);
+    }
+
+    awaitable<void>
+    receive_group_parity(Job &job,
+                         const NumberSequenceParityResponse &parity_response) {
+        const auto first_sequence_index = parity_response.sequence_index();
+
+        if (first_sequence_index < job.next_sequence_index) {
+            job.retransmitted = true;
+            co_await send_request(utils::make_request(
+                create_group_ack_request(job, first_sequence_index)));
+            co_return;
+        }
+
+        if (job.finished || first_sequence_index != job.next_sequence_index) {
+            co_return;
+        }
+
+        if (job.group_responses.empty()) {
+            job.group_responses.resize(parity_response.group_sequence_count());
+        }
+
+        job.group_parity = parity_response;
+        co_await complete_group(job);
+    }
+
+    // A group is complete once all its sequences arrived, or all but one
+    // along with the parity rebuilding it. If the parity arrived and more
+    // sequences are missing, they are reported to the server.
+    awaitable<void> complete_group(Job &job) {
+        auto &group_responses = job.group_responses;
+
+        if (job.group_parity &&
+            std::ranges::count_if(group_responses, is_missing) == 1) {
+            rebuild_group_sequence(job);
+        }
+
+        const auto first_sequence_index = job.next_sequence_index;
+        auto ack_request = create_group_ack_request(job, first_sequence_index);
+
+        if (std::ranges::any_of(group_responses, is_missing)) {
+            if (!job.group_parity) {
+                co_return;
+            }
+
+            ack_request.set_ack(NumberSequenceAck::ACK_INVALID);
+            for (uint64_t index{0}; index < group_responses.size(); ++index) {
+                if (!group_responses[index]) {
+                    ack_request.add_missing_sequence_indices(
+                        first_sequence_index + index);
+                }
+            }
+
+            job.group_parity.reset();
+        } else {
+            for (const auto &response : group_responses) {
+                if (!job.sequence_count) {
+                    job.sequence_count = response->sequence_count();
+                    init_number_sequences(job, *response);
+                }
+
+                process_number_sequence_response(job, *response);
+                ++job.next_sequence_index;
+            }
+
+            group_responses.clear();
+            job.group_parity.reset();
+            job.retransmitted = false;
+
+            if (job.next_sequence_index == *job.sequence_count) {
+                finish_job(job);
+            }
+        }
+
+        job.last_request = utils::make_request(ack_request);
+        job.send_time = std::chrono::steady_clock::now();
+        co_await send_request(job.last_request);
+    }
+
+    static bool
+    is_missing(const std::optional<NumberSequenceResponse> &response) {
+        return !response;
+    }
+
+    // XORing the parity with the sequences received leaves the missing one,
+    // which is dropped if its numbers do not match the rebuilt checksum
+    void rebuild_group_sequence(Job &job) {
+        const auto &parity_response = *job.group_parity;
+        const auto &parity_bytes = parity_response.parity();
+        utils::XorParity parity;
+        parity.add(std::as_bytes(std::span{parity_bytes.data(),
+                                           parity_bytes.size()}),
+                   parity_response.number_count_parity(),
+                   parity_response.checksum_parity());
+
+        for (const auto &response : job.group_responses) {
+            if (response) {
+                const auto &numbers = Traits::numbers(*response);
+                parity.add(std::span{numbers.data(),
+                                     static_cast<size_t>(numbers.size())},
+                           response->checksum());
+            }
+        }
+
+        const auto missing_response =
+            std::ranges::find_if(job.group_responses, is_missing);
+        const auto sequence_index =
+            job.next_sequence_index +
+            static_cast<uint64_t>(missing_response -
+                                  job.group_responses.begin());
+        const auto number_count = parity.number_count();
+
+        if (number_count > parity.bytes().size() / sizeof(NumberType)) {
+            logger_.log("Failed to rebuild number sequence {} of request {}. "
+                        "Number count: {}",
+                        sequence_index, job.request.request_id(), number_count);
+            return;
+        }
+
+        std::vector<NumberType> numbers(number_count);
+        std::memcpy(numbers.data(), parity.bytes().data(),
+                    number_count * sizeof(NumberType));
+
+        const auto checksum = utils::calculate_checksum(numbers);
+        if (checksum != parity.checksum()) {
+            logger_.log("Failed to rebuild number sequence {} of request {}. "
+                        "Expected checksum: {}. Actual checksum: {}",
+                        sequence_index, job.request.request_id(),
+                        parity.checksum(), checksum);
+            return;
+        }
+
+        auto &response = missing_response->emplace();
+        response.set_request_id(job.request.request_id());
+        response.set_number_count(job.request.number_count());
+        response.set_upper_bound(job.request.upper_bound());
+        response.set_sequence_index(sequence_index);
+        response.set_sequence_count(parity_response.sequence_count());
+        response.set_sequence_number_count(number_count);
+        response.set_checksum(checksum);
+        response.set_order(job.request.order());
+        response.set_element_type(job.request.element_type());
+        Traits::mutable_numbers(response)->Add(numbers.begin(), numbers.end());
+
+        logger_.log("Rebuilt number sequence {} of request {} from parity",
+                    sequence_index, job.request.request_id());
+    }
+
+    // Opens the ring the server writes the sequences of the job to and
+    // starts reading it. A repeated response means that the acknowledgement
+    // of the last sequence was lost, which is sent again.
+    awaitable<void>
+    receive_shared_memory_response(Job &job,
+                                   const SharedMemoryResponse &response) {
+        if (job.shared_ring) {
+            if (job.finished) {
+                co_await send_request(job.last_request, job.buffer);
+            }
+
+            co_return;
+        }
+
+        if (job.finished || job.sequence_count ||
+            !job.request.shared_memory()) {
+            co_return;
+        }
+
+        // The server grants shared memory to every client on the host, but
+        // a client running as another user or in another namespace cannot
+        // open the ring. It asks for the request over UDP instead.
+        try {
+            job.shared_ring = std::make_shared<utils::SharedRing>(
+                utils::SharedRing::open(response.path()));
+        } catch (const std::exception &error) {
+            logger_.log("Receiving request {} over UDP instead of shared "
+                        "memory. Error: {}",
+                        job.request.request_id(), error.what());
+        }
+
+        if (!job.shared_ring) {
+            job.request.set_shared_memory(false);
+            job.last_request = utils::make_request(job.request);
+            job.send_time = std::chrono::steady_clock::now();
+            co_await send_request(job.last_request);
+            co_return;
+        }
+
+        job.sequence_count = response.sequence_count();
+        job.sequence_capacity = response.sequence_max_number_count();
+        init_number_sequences(job, job.request.order(),
+                              job.request.number_count(),
+                              response.sequence_count());
+
+        ++shared_memory_reader_count_;
+        co_spawn(strand_, read_shared_memory_sequences(job),
+                 [this](std::exception_ptr error) {
+                     if (error && !shared_memory_error_) {
+                         shared_memory_error_ = error;
+                     }
+
+                     --shared_memory_reader_count_;
+                     shared_memory_readers_timer_.cancel();
+                 });
+    }
+
+    // Closing the rings wakes the readers waiting on them, which then end,
+    // and stops the server writing to them
+    awaitable<void> stop_shared_memory_readers() {
+        for (auto &job : jobs_) {
+            if (job.shared_ring) {
+                job.shared_ring->close();
+            }
+        }
+
+        while (shared_memory_reader_count_ != 0) {
+            shared_memory_readers_timer_.expires_at(
+                steady_timer::time_point::max());
+            co_await shared_memory_readers_timer_.async_wait();
+        }
+    }
+
+    // Takes each sequence in place from the ring, in order, and acknowledges
+    // the last one over UDP. The ring only holds the sequences the server
+    // generated, so a gap or a checksum mismatch ends the run.
+    awaitable<void> read_shared_memory_sequences(Job &job) {
+        const auto ring = job.shared_ring;
+
+        while (job.next_sequence_index < *job.sequence_count) {
+            if (!ring->is_readable() && !ring->is_closed() &&
+                !co_await wait_for_shared_memory_sequence(ring) &&
+                !ring->is_closed()) {
+                throw std::runtime_error{std::format(
+                    "Server stopped writing request {} to shared memory",
+                    job.request.request_id())};
+            }
+
+            // Closed by the server once it fails, or by the client once the
+            // job or the run ends. The server answers the request with its
+            // error, which is retransmitted like any other from now on.
+            if (ring->is_closed()) {
+                if (!job.finished) {
+                    job.shared_ring.reset();
+                }
+
+                co_return;
+            }
+
+            const auto sequence = ring->read<NumberType>();
+            if (sequence.sequence_index != job.next_sequence_index) {
+                throw std::runtime_error{std::format(
+                    "Unexpected number sequence {} of request {} in shared "
+                    "memory. Expected sequence: {}",
+                    sequence.sequence_index, job.request.request_id(),
+                    job.next_sequence_index)};
+            }
+
+            const auto checksum = utils::calculate_checksum(sequence.numbers);
+            if (checksum != sequence.checksum) {
+                throw std::runtime_error{std::format(
+                    "Invalid number sequence {} of request {} in shared "
+                    "memory. Expected checksum: {}. Actual checksum: {}",
+                    sequence.sequence_index, job.request.request_id(),
+                    sequence.checksum, checksum)};
+            }
+
+            add_number_sequence(job, sequence.sequence_index,
+                                job.request.order(), sequence.numbers);
+            ring->pop();
+            ++job.next_sequence_index;
+        }
+
+        // Finished only once sent, the run ends with the last job
+        job.last_request =
+            utils::make_request(create_shared_memory_ack_request(job));
+        co_await send_request(job.last_request, job.buffer);
+        finish_job(job);
+    }
+
+    // The futex is waited on by a waiter thread, so that the other jobs and
+    // the socket are served meanwhile
+    awaitable<bool>
+    wait_for_shared_memory_sequence(std::shared_ptr<utils::SharedRing> ring) {
+        co_return co_await co_spawn(
+            *shared_memory_waiter_,
+            [ring]() -> awaitable<bool> {
+                co_return ring->wait_readable(SHARED_MEMORY_TIMEOUT);
+            },
+            boost::asio::use_awaitable);
+    }
+
+    // Subscribes every job to a multicast stream. Sequences published to the
+    // group may arrive in any order or not at all; a gap is NACKed as soon
+    // as a later sequence arrives and the missing sequences are NACKed again
+    // while the server is silent. Repairs arrive over unicast.
+    awaitable<void> receive_multicast_number_sequences() {
+        for (auto &job : jobs_) {
+            co_await send_request(job.last_request);
+        }
+
+        auto unfinished_job_count = jobs_.size();
+        uint8_t retry_index{0};
+
+        while (unfinished_job_count != 0) {
+            // Streams wait for further subscribers before publishing
+            steady_timer timer{socket_.get_executor(),
+                               rtt_.timeout() + MULTICAST_JOIN_WINDOW};
+            const auto response = co_await receive_response(timer);
+
+            if (!response) {
+                const auto now = std::chrono::steady_clock::now();
+                if (!are_jobs_deferred(now)) {
+                    handle_timeout(retry_index, unfinished_job_count);
+                }
+
+                for (auto &job : jobs_) {
+                    if (job.finished || job.retry_time > now) {
+                        continue;
+                    }
+
+                    if (job.stream_id) {
+                        co_await send_nack_request(job, 0,
+                                                   *job.sequence_count);
+                    } else {
+                        co_await send_request(job.last_request);
+                    }
+                }
+
+                continue;
+            }
+
+            retry_index = 0;
+
+            if (const auto *stream_response =
+                    utils::get_payload<MulticastStreamResponse>(*response)) {
+                if (stream_response->request_id() < jobs_.size()) {
+                    subscribe_job(jobs_[stream_response->request_id()],
+                                  *stream_response);
+                }
+
+                continue;
+            }
+
+            const auto *sequence_response =
+                utils::get_payload<NumberSequenceResponse>(*response);
+            if (!sequence_response) {
+                continue;
+            }
+
+            if (sequence_response->error() !=
+                NumberSequenceError::SEQUENCE_OK) {
+                if (sequence_response->request_id() >= jobs_.size()) {
+                    continue;
+                }
+
+                auto &job = jobs_[sequence_response->request_id()];
+                if (!defer_job(job, *sequence_response) && !job.finished) {
+                    fail_job(job, *sequence_response);
+                    --unfinished_job_count;
+                }
+
+                continue;
+            }
+
+            const auto checksum =
+                utils::calculate_checksum(Traits::numbers(*sequence_response));
+            if (checksum != sequence_response->checksum()) {
+                logger_.log("Dropping number sequence {} of stream {}. "
+                            "Expected checksum: {}. Actual checksum: {}",
+                            sequence_response->sequence_index(),
+                            sequence_response->stream_id(),
+                            sequence_response->checksum(), checksum);
+                continue;
+            }
+
+            // Identical requests share a stream, so does a sequence
+            for (auto &job : jobs_) {
+                if (job.finished ||
+                    job.stream_id != sequence_response->stream_id()) {
+                    continue;
+                }
+
+                co_await receive_stream_sequence(job, *sequence_response);
+
+                if (job.finished) {
+                    --unfinished_job_count;
+                }
+            }
+        }
+    }
+
+    void fail_job(Job &job, const NumberSequenceResponse &response) {
+        logger_.log("Number sequence response error for request {}: {}",
+                    response.request_id(), response.error_message());
+
+        job.result.error = response.error();
+        job.result.error_message = response.error_message();
+
+        // Stops the reader of the ring, and the server writing to it
+        if (job.shared_ring) {
+            job.shared_ring->close();
+        }
+
+        remove_numbers_file(job);
+        job.number_sequences = {};
+        job.landing_buffer = {};
+        job.pending_sequences = {};
+        job.finished = true;
+    }
+
+    void handle_timeout(uint8_t &retry_index, uint64_t unfinished_job_count) {
+        if (retry_index == SEQUENCE_RESPONSE_MAX_RETRIES_COUNT) {
+            throw std::runtime_error{std::format(
+                "Server stopped responding. Unfinished requests: {}",
+                unfinished_job_count)};
+        }
+
+        logger_.log(
+            "Timed out waiting for number sequences. Timeout: {}. Retry: {}",
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                rtt_.timeout()),
+            retry_index);
+
+        ++retry_index;
+        rtt_.backoff();
+    }
+
+    size_t count_unfinished_jobs() const {
+        return static_cast<size_t>(std::ranges::count_if(
+            jobs_, [](const Job &job) { return !job.finished; }));
+    }
+
+    // Jobs waiting out a retry-after hint, or read from shared memory, do
+    // not count as lost
+    bool are_jobs_deferred(std::chrono::steady_clock::time_point now) const {
+        return std::ranges::all_of(jobs_, [&](const Job &job) {
+            return job.finished || job.shared_ring || job.retry_time > now;
+        });
+    }
+
+    // An overloaded server is asked again once its retry-after hint
+    // expires. Returns false for the errors ending the job.
+    bool defer_job(Job &job, const NumberSequenceResponse &response) {
+        if (response.error() != NumberSequenceError::OVERLOADED) {
+            return false;
+        }
+
+        // Late rejections of a request admitted since are ignored
+        if (job.finished || job.sequence_count || job.stream_id) {
+            return true;
+        }
+
+        logger_.log("Server is overloaded, repeating request {} in {} ms",
+                    response.request_id(), response.retry_after_ms());
+        job.retry_time = std::chrono::steady_clock::now() +
+                         std::chrono::milliseconds{response.retry_after_ms()};
+
+        return true;
+    }
+
+    void subscribe_job(Job &job, const MulticastStreamResponse &response) {
+        if (job.stream_id) {
+            return;
+        }
+
+        join_multicast_group(response);
+
+        job.stream_id = response.stream_id();
+        job.sequence_count = response.sequence_count();
+        job.received_sequences.assign(response.sequence_count(), false);
+    }
+
+    awaitable<void>
+    receive_stream_sequence(Job &job, const NumberSequenceResponse &response) {
+        const auto sequence_index = response.sequence_index();
+        if (sequence_index >= *job.sequence_count ||
+            job.received_sequences[sequence_index]) {
+            co_return;
+        }
+
+        if (job.received_count == 0) {
+            init_number_sequences(job, response);
+        }
+
+        process_number_sequence_response(job, response);
+        job.received_sequences[sequence_index] = true;
+        ++job.received_count;
+
+        if (sequence_index > job.next_sequence_index) {
+            co_await send_nack_request(job, job.next_sequence_index,
+                                       sequence_index);
+        }
+
+        job.next_sequence_index =
+            std::max(job.next_sequence_index, sequence_index + 1);
+
+        if (job.received_count == *job.sequence_count) {
+            finish_job(job);
+
+            // Lets the server close the stream without waiting for the
+            // subscription to fall silent
+            auto nack_request = create_number_sequence_nack_request(job);
+            nack_request.set_complete(true);
+            co_await send_request(utils::make_request(nack_request));
+        }
+    }
+
+    // NACKs the sequences missing in [begin_index, end_index), at most
+    // NACK_MAX_SEQUENCE_COUNT of them
+    awaitable<void> send_nack_request(const Job &job, uint64_t begin_index,
+                                      uint64_t end_index) {
+        auto nack_request = create_number_sequence_nack_request(job);
+
+        for (auto sequence_index = begin_index;
+             sequence_index < end_index &&
+             nack_request.sequence_indices_size() < NACK_MAX_SEQUENCE_COUNT;
+             ++sequence_index) {
+            if (!job.received_sequences[sequence_index]) {
+                nack_request.add_sequence_indices(sequence_index);
+            }
+        }
+
+        if (nack_request.sequence_indices_size() != 0) {
+            co_await send_request(utils::make_request(nack_request));
+        }
+    }
+
+    // The streams of all jobs are published to the group of the server
+    void join_multicast_group(const MulticastStreamResponse &response) {
+        namespace multicast = boost::asio::ip::multicast;
+
+        if (multicast_socket_) {
+            return;
+        }
+
+        const auto group =
+            boost::asio::ip::make_address_v4(response.group_address());
+        auto &socket = multicast_socket_.emplace(io_context_);
+
+        socket.open(udp::v4());
+        socket.set_option(boost::asio::socket_base::reuse_address(true));
+        socket.bind(
+            udp::endpoint{udp::v4(), static_cast<uint16_t>(response.port())});
+
+        if (config_.multicast_interface().empty()) {
+            socket.set_option(multicast::join_group(group));
+        } else {
+            socket.set_option(multicast::join_group(
+                group, boost::asio::ip::make_address_v4(
+                           config_.multicast_interface())));
+        }
+
+        multicast_buffer_.assign(MESSAGE_MAX_SIZE, '\0');
+    }
+
+    awaitable<void> send_request(const Request &request) {
+        co_await send_request(request, buffer_);
+    }
+
+    // Requests sent concurrently each need their own buffer
+    awaitable<void> send_request(const Request &request, std::string &buffer) {
+        buffer.clear();
+        request.SerializeToString(&buffer);
+
+        logger_.log("Sending request to {}\nRequest: {}",
+                    endpoint_.address().to_string(), request);
+
+        const auto [request_error, request_length] =
+            co_await socket_.async_send_to(
+                boost::asio::buffer(buffer.data(), buffer.size()), endpoint_);
+
+        if (request_error) {
+            throw std::runtime_error{std::format(
+                "Failed to send request\nError: {}", request_error.message())};
+        }
+
+        if (request_length == 0) {
+            throw std::runtime_error{
+                "Failed to send request\nError: no bytes sent"};
+        }
+    }
+
+    // Waits for a response of the given type until the timeout expires.
+    // Responses of other types and receive errors are treated as lost
+    // datagrams.
+    template <typename ResponseType>
+    awaitable<std::optional<ResponseType>>
+    receive_response(steady_timer::duration timeout) {
+        steady_timer timer{socket_.get_executor(), timeout};
+
+        for (;;) {
+            const auto response = co_await receive_response(timer);
+            if (!response) {
+                co_return std::nullopt;
+            }
+
+            if (const auto *payload =
+                    utils::get_payload<ResponseType>(*response)) {
+                co_return *payload;
+            }
+        }
+    }
+
+    // Once a multicast group is joined, its datagrams are received alongside
+    // the unicast ones
+    awaitable<std::optional<Response>> receive_response(steady_timer &timer) {
+        if (!multicast_socket_) {
+            auto result = co_await (receive_response(socket_, buffer_,
+                                                     endpoint_) ||
+                                    timer.async_wait());
+            if (result.index() == 1) {
+                co_return std::nullopt;
+            }
+
+            co_return std::get<0>(std::move(result));
+        }
+
+        auto result = co_await (
+            receive_response(socket_, buffer_, endpoint_) ||
+            receive_response(*multicast_socket_, multicast_buffer_,
+                             multicast_endpoint_) ||
+            timer.async_wait());
+
+        switch (result.index()) {
+        case 0:
+            co_return std::get<0>(std::move(result));
+        case 1:
+            co_return std::get<1>(std::move(result));
+        default:
+            co_return std::nullopt;
+        }
+    }
+
+    // Receive errors drop the datagram and the socket keeps receiving. An
+    // ICMP port unreachable for an earlier request, e.g. while the server is
+    // not started yet, surfaces as a connection reset on Windows. Only the
+    // cancellation by the timer ends the wait.
+    awaitable<Response> receive_response(udp_socket &socket,
+                                         std::string &buffer,
+                                         udp::endpoint &endpoint) {
+        size_t response_length{0};
+
+        for (;;) {
+            buffer.resize(buffer.capacity());
+            const auto [response_error, length] =
+                co_await socket.async_receive_from(
+                    boost::asio::buffer(buffer.data(), buffer.size()),
+                    endpoint);
+
+            if (response_error == boost::asio::error::operation_aborted) {
+                throw std::runtime_error{"Receiving response was cancelled"};
+            }
+
+            if (!response_error && length != 0) {
+                response_length = length;
+                break;
+            }
+
+            logger_.log("Failed to receive response\nError: {}",
+                        response_error ? response_error.message()
+                                       : "no bytes received");
+        }
+
+        buffer.resize(response_length);
+        Response response;
+        response.ParseFromString(buffer);
+
+        logger_.log("Received response from {}\nResponse: {}",
+                    endpoint.address().to_string(), response);
+
+        co_return response;
+    }
+
+    void init_jobs() {
+        const auto &requests = config_.requests();
+        jobs_.resize(requests.size());
+
+        for (uint64_t job_index{0}; job_index < jobs_.size(); ++job_index) {
+            auto &job = jobs_[job_index];
+            job.request =
+                create_number_sequence_request(requests[job_index], job_index);
+            job.numbers_file_path =
+                get_numbers_file_path(numbers_file_path_, job_index);
+            job.result.request_id = job_index;
+            job.result.numbers_file_path = job.numbers_file_path;
+            job.last_request = utils::make_request(job.request);
+        }
+    }
+
+    void finish_job(Job &job) {
+        if (config_.server_side_sort()) {
+            if (job.numbers_file.is_open()) {
+                const size_t numbers_size{job.request.number_count()};
+                job.numbers_file.seekp(0);
+                job.numbers_file.write(
+                    reinterpret_cast<const char *>(&numbers_size),
+                    sizeof(numbers_size));
+                job.numbers_file.close();
+            }
+        } else {
+            sort_number_sequences(job);
+            emit_sorted_numbers(job);
+
+            if (!job.numbers_file_path.empty()) {
+                flush_numbers(job);
+            }
+        }
+
+        job.number_sequences = {};
+        job.landing_buffer = {};
+        job.result.number_count = job.request.number_count();
+        job.finished = true;
+    }
+
+    void process_number_sequence_response(
+        Job &job, const protocol::NumberSequenceResponse &response) {
+        const auto &numbers = Traits::numbers(response);
+        add_number_sequence(
+            job, response.sequence_index(), response.order(),
+            std::span{numbers.data(), static_cast<size_t>(numbers.size())});
+    }
+
+    void add_number_sequence(Job &job, uint64_t sequence_index,
+                             NumberOrder order,
+                             std::span<const NumberType> numbers) {
+        if (handlers_.on_sequence) {
+            handlers_.on_sequence(job.request.request_id(), sequence_index,
+                                  numbers);
+        }
+
+        // Sorted sequences are written to the file as is. They arrive in
+        // order, except from a multicast stream.
+        if (order == NumberOrder::DESCENDING) {
+            if (job.numbers_file.is_open()) {
+                if (job.stream_id) {
+                    job.numbers_file.seekp(
+                        sizeof(size_t) + sizeof(NumberType) * sequence_index *
+                                             job.sequence_capacity);
+                }
+
+                write_numbers(job, numbers);
+            }
+
+            emit_sorted_sequence(job, sequence_index, numbers);
+            return;
+        }
+
+        auto &number_sequences = job.number_sequences;
+
+        if (config_.landing_buffer()) {
+            const auto offset = sequence_index * job.sequence_capacity;
+            if (numbers.size() > job.sequence_capacity ||
+                offset + numbers.size() > job.landing_buffer.size()) {
+                throw std::runtime_error{std::format(
+                    "Number sequence {} does not fit the landing buffer",
+                    sequence_index)};
+            }
+
+            std::ranges::copy(numbers,
+                              job.landing_buffer.numbers().begin() + offset);
+            return;
+        }
+
+        // The radix sort runs once over all numbers, which are collected in
+        // a single sequence
+        if (config_.sort_algorithm() == client::SortAlgorithm::RADIX) {
+            number_sequences.back().insert(number_sequences.back().end(),
+                                           numbers.begin(), numbers.end());
+            return;
+        }
+
+        number_sequences.push_back(
+            std::vector<NumberType>{numbers.begin(), numbers.end()});
+        std::sort(std::execution::par, number_sequences.back().begin(),
+                  number_sequences.back().end(), std::greater<NumberType>{});
+    }
+
+    void
+    init_number_sequences(Job &job,
+                          const protocol::NumberSequenceResponse &response) {
+        job.sequence_capacity = get_sequence_capacity(response);
+        init_number_sequences(job, response.order(), response.number_count(),
+                              response.sequence_count());
+    }
+
+    void init_number_sequences(Job &job, NumberOrder order,
+                               uint64_t number_count, uint64_t sequence_count) {
+        if (order == NumberOrder::DESCENDING) {
+            // The count is written by finish_job, so a file left behind by
+            // a failed transfer claims no numbers
+            if (!job.numbers_file_path.empty()) {
+                open_numbers_file(job, 0);
+            }
+        } else if (config_.landing_buffer()) {
+            job.landing_buffer = client::LandingBuffer<NumberType>{
+                number_count, config_.huge_pages()};
+        } else if (config_.sort_algorithm() == client::SortAlgorithm::RADIX) {
+            job.number_sequences.emplace_back().reserve(number_count);
+        } else {
+            job.number_sequences.reserve(sequence_count);
+        }
+    }
+
+    // Every sequence but the last is full, so any sequence gives the slot
+    // size of a sequence in the numbers of the job
+    static uint64_t
+    get_sequence_capacity(const protocol::NumberSequenceResponse &response) {
+        if (response.sequence_index() + 1 < response.sequence_count() ||
+            response.sequence_count() == 1) {
+            return response.sequence_number_count();
+        }
+
+        return (response.number_count() - response.sequence_number_count()) /
+               (response.sequence_count() - 1);
+    }
+
+    void sort_number_sequences(Job &job) {
+        if (config_.landing_buffer()) {
+            const auto numbers = job.landing_buffer.numbers();
+
+            if (config_.sort_algorithm() == client::SortAlgorithm::RADIX) {
+                utils::radix_sort_descending(numbers);
+            } else {
+                std::sort(std::execution::par, numbers.begin(), numbers.end(),
+                          std::greater<NumberType>{});
+            }
+        } else if (config_.sort_algorithm() == client::SortAlgorithm::RADIX) {
+            utils::radix_sort_descending(
+                std::span<NumberType>{job.number_sequences.front()});
+        } else {
+            merge_number_sequences(job.number_sequences);
+        }
+    }
+
+    void merge_number_sequences(
+        std::vector<std::vector<NumberType>> &number_sequences) {
+        while (number_sequences.size() > 1) {
+            const auto &first_sequence = *(number_sequences.end() - 2);
+            const auto &second_sequence = *(number_sequences.end() - 1);
+            std::vector<NumberType> merged_sequence;
+            merged_sequence.reserve(first_sequence.size() +
+                                    second_sequence.size());
+
+            std::merge(first_sequence.begin(), first_sequence.end(),
+                       second_sequence.begin(), second_sequence.end(),
+                       std::back_inserter(merged_sequence),
+                       std::greater<NumberType>{});
+
+            number_sequences.erase(number_sequences.end() - 2,
+                                   number_sequences.end());
+            number_sequences.push_back(std::move(merged_sequence));
+        }
+    }
+
+    std::span<const NumberType> get_sorted_numbers(const Job &job) const {
+        if (config_.landing_buffer()) {
+            return job.landing_buffer.numbers();
+        }
+
+        return job.number_sequences.front();
+    }
+
+    // Sorted sequences are handed out in order, those of a multicast stream
+    // arriving early wait for their predecessors
+    void emit_sorted_sequence(Job &job, uint64_t sequence_index,
+                              std::span<const NumberType> sequence) {
+        if (!handlers_.on_sorted) {
+            return;
+        }
+
+        if (sequence_index != job.next_sorted_index) {
+            job.pending_sequences.emplace(
+                sequence_index,
+                std::vector<NumberType>{sequence.begin(), sequence.end()});
+            return;
+        }
+
+        handlers_.on_sorted(job.request.request_id(), sequence);
+        ++job.next_sorted_index;
+
+        for (auto pending_sequence = job.pending_sequences.begin();
+             pending_sequence != job.pending_sequences.end() &&
+             pending_sequence->first == job.next_sorted_index;
+             pending_sequence = job.pending_sequences.erase(pending_sequence)) {
+            handlers_.on_sorted(job.request.request_id(),
+                                pending_sequence->second);
+            ++job.next_sorted_index;
+        }
+    }
+
+    // Numbers sorted by the client are handed out in chunks of the sequence
+    // size
+    void emit_sorted_numbers(const Job &job) {
+        if (!handlers_.on_sorted) {
+            return;
+        }
+
+        const auto numbers = get_sorted_numbers(job);
+        const auto chunk_size =
+            std::max<size_t>(job.sequence_capacity, size_t{1});
+
+        for (size_t offset{0}; offset < numbers.size(); offset += chunk_size) {
+            handlers_.on_sorted(
+                job.request.request_id(),
+                numbers.subspan(offset,
+                                std::min(chunk_size, numbers.size() - offset)));
+        }
+    }
+
+    void flush_numbers(Job &job) {
+        const auto numbers = get_sorted_numbers(job);
+
+        open_numbers_file(job, numbers.size());
+        write_numbers(job, numbers);
+        job.numbers_file.close();
+    }
+
+    void open_numbers_file(Job &job, size_t numbers_size) {
+        job.numbers_file.open(job.numbers_file_path,
+                              std::ios::binary | std::ios::trunc);
+
+        if (!job.numbers_file) {
+            throw std::runtime_error{
+                std::format("Failed to open numbers file. Path: {}",
+                            job.numbers_file_path.string())};
+        }
+
+        job.numbers_file.write(reinterpret_cast<const char *>(&numbers_size),
+                               sizeof(numbers_size));
+    }
+
+    // Drops the numbers written so far by a job that failed
+    void remove_numbers_file(Job &job) {
+        if (!job.numbers_file.is_open()) {
+            return;
+        }
+
+        job.numbers_file.close();
+
+        std::error_code error;
+        std::filesystem::remove(job.numbers_file_path, error);
+    }
+
+    void write_numbers(Job &job, const auto &numbers) {
+        job.numbers_file.write(reinterpret_cast<const char *>(numbers.data()),
+                               sizeof(NumberType) * numbers.size());
+    }
+
+    ProtocolVersionRequest create_protocol_version_request() const {
+        ProtocolVersionRequest request;
+        request.set_protocol_version(PROTOCOL_VERSION);
+        request.set_shared_memory(config_.shared_memory() &&
+                                  utils::SHARED_MEMORY_SUPPORTED);
+
+        return request;
+    }
+
+    NumberSequenceRequest
+    create_number_sequence_request(const client::NumberRequest &number_request,
+                                   uint64_t request_id) const {
+        NumberSequenceRequest request;
+        request.set_number_count(number_request.number_count);
+        request.set_upper_bound(number_request.upper_bound);
+        if (number_request.lower_bound) {
+            request.set_lower_bound(*number_request.lower_bound);
+        }
+        request.set_order(config_.server_side_sort() ? NumberOrder::DESCENDING
+                                                     : NumberOrder::UNORDERED);
+        request.set_element_type(config_.element_type());
+        request.set_distribution(config_.distribution());
+        request.set_session_token(session_token_);
+        request.set_request_id(request_id);
+        request.set_multicast(config_.multicast());
+        request.set_fec_group_size(config_.fec_group_size());
+        request.set_shared_memory(shared_memory_ && !config_.multicast());
+
+        return request;
+    }
+
+    NumberSequenceAckRequest create_number_sequence_ack_request(
+        const NumberSequenceResponse &response) const {
+        NumberSequenceAckRequest ack_request;
+        ack_request.set_sequence_index(response.sequence_index());
+        ack_request.set_checksum(
+            utils::calculate_checksum(Traits::numbers(response)));
+        ack_request.set_ack((response.checksum() == ack_request.checksum())
+                                ? protocol::NumberSequenceAck::ACK_OK
+                                : protocol::NumberSequenceAck::ACK_INVALID);
+        ack_request.set_session_token(session_token_);
+        ack_request.set_request_id(response.request_id());
+
+        return ack_request;
+    }
+
+    NumberSequenceAckRequest
+    create_group_ack_request(const Job &job,
+                             uint64_t first_sequence_index) const {
+        NumberSequenceAckRequest ack_request;
+        ack_request.set_sequence_index(first_sequence_index);
+        ack_request.set_ack(protocol::NumberSequenceAck::ACK_OK);
+        ack_request.set_session_token(session_token_);
+        ack_request.set_request_id(job.request.request_id());
+
+        return ack_request;
+    }
+
+    // Acknowledges the last sequence, and with it the whole ring
+    NumberSequenceAckRequest
+    create_shared_memory_ack_request(const Job &job) const {
+        NumberSequenceAckRequest ack_request;
+        ack_request.set_sequence_index(*job.sequence_count - 1);
+        ack_request.set_ack(protocol::NumberSequenceAck::ACK_OK);
+        ack_request.set_session_token(session_token_);
+        ack_request.set_request_id(job.request.request_id());
+
+        return ack_request;
+    }
+
+    NumberSequenceNackRequest
+    create_number_sequence_nack_request(const Job &job) const {
+        NumberSequenceNackRequest nack_request;
+        nack_request.set_session_token(session_token_);
+        nack_request.set_request_id(job.request.request_id());
+
+        return nack_request;
+    }
+
+private:
+    static constexpr uint32_t PROTOCOL_VERSION{3};
+
+    boost::asio::io_context &io_context_;
+    udp_socket socket_;
+    udp::endpoint endpoint_;
+    std::string buffer_;
+    client::Config config_;
+    std::filesystem::path numbers_file_path_;
+    utils::Logger &logger_;
+    Handlers<NumberType> handlers_;
+    utils::RttEstimator rtt_;
+    uint64_t session_token_{};
+    bool started_{false};
+    std::vector<Job> jobs_;
+    std::optional<udp_socket> multicast_socket_;
+    udp::endpoint multicast_endpoint_;
+    std::string multicast_buffer_;
+    boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+    // Granted by the handshake. The rings are waited on by their own
+    // threads, the first error of a coroutine reading one ends the run.
+    bool shared_memory_{false};
+    std::optional<boost::asio::thread_pool> shared_memory_waiter_;
+    std::exception_ptr shared_memory_error_;
+    uint64_t shared_memory_reader_count_{0};
+    // Cancelled by every reader once it ends
+    steady_timer shared_memory_readers_timer_;
+};
+
+// Compiled once into udp_client_core
+extern template class UDPNumberSorterClient<
+    utils::ElementTraits<protocol::ELEMENT_FLOAT64>>;
+extern template class UDPNumberSorterClient<
+    utils::ElementTraits<protocol::ELEMENT_FLOAT32>>;
+extern template class UDPNumberSorterClient<
+    utils::ElementTraits<protocol::ELEMENT_INT32>>;
+extern template class UDPNumberSorterClient<
+    utils::ElementTraits<protocol::ELEMENT_INT64>>;
+
+} // namespace client
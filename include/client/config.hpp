@@ -1,24 +1,92 @@
 #pragma once
 
+#include "protocol.pb.h"
+
 #include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace client {
 
+enum class SortAlgorithm {
+    // Sorts every sequence on arrival and merges the sorted sequences
+    COMPARISON,
+    // Collects all numbers and sorts them once with a parallel radix sort
+    RADIX,
+};
+
+struct NumberRequest {
+    uint64_t number_count{};
+    double upper_bound{};
+    // -upper_bound if unset
+    std::optional<double> lower_bound;
+};
+
+// A job is divided across the servers in proportion to their weights
+struct ServerAddress {
+    std::string host;
+    uint16_t port{};
+    double weight{1.0};
+};
+
+// Read from the config file, or filled in by an application embedding the
+// client
+struct Settings {
+    std::vector<ServerAddress> servers;
+    std::vector<NumberRequest> requests;
+    bool server_side_sort{};
+    protocol::ElementType element_type{protocol::ELEMENT_FLOAT64};
+    protocol::Distribution distribution{protocol::DISTRIBUTION_UNIFORM};
+    SortAlgorithm sort_algorithm{SortAlgorithm::COMPARISON};
+    bool landing_buffer{};
+    bool huge_pages{};
+    bool multicast{};
+    std::string multicast_interface;
+    // Asks for a parity datagram after every fec_group_size sequences,
+    // zero disables forward error correction
+    uint32_t fec_group_size{};
+    // Offers to read the sequences from shared memory, granted by a server
+    // on the same host
+    bool shared_memory{};
+};
+
 class Config {
 public:
     Config();
     Config(const std::filesystem::path &path);
+    Config(Settings settings);
 
-    inline uint16_t port() const { return port_; }
-    inline const std::string &host() const { return host_; }
-    inline uint64_t number_count() const { return number_count_; }
-    inline double upper_bound() const { return upper_bound_; }
+    inline const Settings &settings() const { return settings_; }
+    inline const std::vector<ServerAddress> &servers() const {
+        return settings_.servers;
+    }
+    inline const std::vector<NumberRequest> &requests() const {
+        return settings_.requests;
+    }
+    inline bool server_side_sort() const { return settings_.server_side_sort; }
+    inline protocol::ElementType element_type() const {
+        return settings_.element_type;
+    }
+    inline protocol::Distribution distribution() const {
+        return settings_.distribution;
+    }
+    inline SortAlgorithm sort_algorithm() const {
+        return settings_.sort_algorithm;
+    }
+    inline bool landing_buffer() const { return settings_.landing_buffer; }
+    inline bool huge_pages() const { return settings_.huge_pages; }
+    inline bool multicast() const { return settings_.multicast; }
+    inline const std::string &multicast_interface() const {
+        return settings_.multicast_interface;
+    }
+    inline uint32_t fec_group_size() const { return settings_.fec_group_size; }
+    inline bool shared_memory() const { return settings_.shared_memory; }
 
 private:
-    uint16_t port_{};
-    std::string host_;
-    uint64_t number_count_{};
-    double upper_bound_{};
+    void validate() const;
+
+    Settings settings_;
 };
 
 } // namespace client
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace client {
+
+// One contiguous array receiving all numbers of a request, every sequence
+// is decoded into its own slot and the array is sorted in place once
+// complete. On Linux the array is mapped anonymously and may be backed by
+// transparent huge pages, which cuts the TLB misses of the final sort.
+template <typename NumberType> class LandingBuffer {
+public:
+    LandingBuffer() = default;
+
+    LandingBuffer(size_t size, bool huge_pages) : size_{size} {
+        if (size_ == 0) {
+            return;
+        }
+
+#if defined(__linux__)
+        constexpr size_t huge_page_size{size_t{2} << 20};
+
+        // Huge pages need a mapping aligned to their size, the mapping is
+        // over-allocated by one huge page and the array starts at the first
+        // boundary in it
+        const auto byte_count = size_ * sizeof(NumberType);
+        mapping_size_ = huge_pages ? byte_count + huge_page_size : byte_count;
+
+        mapping_ = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping_ == MAP_FAILED) {
+            mapping_ = nullptr;
+            throw std::runtime_error{std::format(
+                "Failed to map landing buffer of {} bytes", mapping_size_)};
+        }
+
+        auto address = reinterpret_cast<uintptr_t>(mapping_);
+        if (huge_pages) {
+            address = (address + huge_page_size - 1) & ~(huge_page_size - 1);
+
+            // Without transparent huge page support the buffer stays on
+            // regular pages
+            madvise(reinterpret_cast<void *>(address), byte_count,
+                    MADV_HUGEPAGE);
+        }
+
+        data_ = reinterpret_cast<NumberType *>(address);
+#else
+        static_cast<void>(huge_pages);
+        data_ = new NumberType[size_];
+#endif
+    }
+
+    LandingBuffer(const LandingBuffer &) = delete;
+    LandingBuffer &operator=(const LandingBuffer &) = delete;
+
+    LandingBuffer(LandingBuffer &&other) noexcept
+        : data_{std::exchange(other.data_, nullptr)},
+          size_{std::exchange(other.size_, 0)},
+          mapping_{std::exchange(other.mapping_, nullptr)},
+          mapping_size_{std::exchange(other.mapping_size_, 0)} {}
+
+    LandingBuffer &operator=(LandingBuffer &&other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            mapping_ = std::exchange(other.mapping_, nullptr);
+            mapping_size_ = std::exchange(other.mapping_size_, 0);
+        }
+
+        return *this;
+    }
+
+    ~LandingBuffer() { release(); }
+
+    inline size_t size() const { return size_; }
+    inline std::span<NumberType> numbers() { return {data_, size_}; }
+    inline std::span<const NumberType> numbers() const {
+        return {data_, size_};
+    }
+
+private:
+    void release() {
+#if defined(__linux__)
+        if (mapping_) {
+            munmap(mapping_, mapping_size_);
+        }
+#else
+        delete[] data_;
+#endif
+
+        data_ = nullptr;
+        size_ = 0;
+        mapping_ = nullptr;
+        mapping_size_ = 0;
+    }
+
+    NumberType *data_{nullptr};
+    size_t size_{0};
+    void *mapping_{nullptr};
+    size_t mapping_size_{0};
+};
+
+} // namespace client
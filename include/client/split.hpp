@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace client {
+
+// Shares the number count in proportion to the capacities, the rounding
+// remainder goes to the sub-intervals with room left. A count exceeding
+// the capacities is left to the servers to reject.
+inline std::vector<uint64_t>
+split_number_count(uint64_t number_count,
+                   const std::vector<double> &capacities) {
+    const auto total_capacity =
+        std::accumulate(capacities.begin(), capacities.end(), 0.0);
+    std::vector<uint64_t> counts(capacities.size());
+    uint64_t assigned_count{0};
+
+    if (total_capacity > 0) {
+        for (size_t index{0}; index < capacities.size(); ++index) {
+            counts[index] = static_cast<uint64_t>(
+                std::floor(static_cast<double>(number_count) *
+                           (capacities[index] / total_capacity)));
+            counts[index] = std::min(counts[index],
+                                     number_count - assigned_count);
+            assigned_count += counts[index];
+        }
+    }
+
+    for (bool assigned{true}; assigned && assigned_count < number_count;) {
+        assigned = false;
+
+        for (size_t index{0};
+             index < capacities.size() && assigned_count < number_count;
+             ++index) {
+            if (static_cast<double>(counts[index]) < capacities[index]) {
+                ++counts[index];
+                ++assigned_count;
+                assigned = true;
+            }
+        }
+    }
+
+    counts.front() += number_count - assigned_count;
+
+    return counts;
+}
+
+} // namespace client
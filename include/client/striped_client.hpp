@@ -0,0 +1,416 @@
+#pragma once
+
+#include "client/client.hpp"
+#include "client/config.hpp"
+#include "client/split.hpp"
+#include "protocol.pb.h"
+#include "utils/element_type.hpp"
+#include "utils/logger.hpp"
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/use_future.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace client {
+
+// Divides every request across the servers of the config. Each server gets
+// a disjoint sub-interval of the range and a share of the number count in
+// proportion to its weight, so the numbers stay unique without the servers
+// coordinating. The sorted numbers of a request are those of its stripes one
+// after another, highest sub-interval first, so no merge is needed.
+//
+// A server that cannot be reached or stops responding is given up, its
+// stripes are requested again from the next live server. The numbers of a
+// request are handed to on_sorted and written once all its stripes are
+// complete; on_sequence sees the sequences of every stripe, including those
+// of a stripe that is requested again later.
+template <typename Traits> class StripedClient {
+public:
+    using NumberType = typename Traits::value_type;
+
+    StripedClient(boost::asio::io_context &io_context, client::Config config,
+                  std::filesystem::path numbers_file_path,
+                  utils::Logger &logger, Handlers<NumberType> handlers = {})
+        : io_context_{io_context}, config_{std::move(config)},
+          numbers_file_path_{std::move(numbers_file_path)}, logger_{logger},
+          handlers_{std::move(handlers)},
+          strand_{boost::asio::make_strand(io_context)}, done_timer_{strand_},
+          dead_servers_(config_.servers().size(), false) {}
+
+    std::future<std::vector<JobResult>> start() {
+        return co_spawn(io_context_, async_run(), boost::asio::use_future);
+    }
+
+    // Serves every request of the config across the servers. Throws if the
+    // stripes of a request cannot be served by any server. Runs only once,
+    // like UDPNumberSorterClient.
+    awaitable<std::vector<JobResult>> async_run() {
+        if (std::exchange(started_, true)) {
+            throw std::runtime_error{"The client has already been run"};
+        }
+
+        co_return co_await co_spawn(strand_, run_servers(),
+                                    boost::asio::use_awaitable);
+    }
+
+private:
+    // The part of a request served by one server
+    struct Stripe {
+        uint64_t job_index{};
+        size_t server_index{};
+        NumberRequest request;
+        std::vector<NumberType> numbers;
+        JobResult result;
+    };
+
+    // The server runs share the stripes and the counts, they all run on the
+    // strand so that the io_context may have several threads
+    awaitable<std::vector<JobResult>> run_servers() {
+        init_stripes();
+
+        std::vector<std::vector<size_t>> server_stripes(
+            config_.servers().size());
+        for (size_t stripe_index{0}; stripe_index < stripes_.size();
+             ++stripe_index) {
+            server_stripes[stripes_[stripe_index].server_index].push_back(
+                stripe_index);
+        }
+
+        for (size_t server_index{0}; server_index < server_stripes.size();
+             ++server_index) {
+            if (!server_stripes[server_index].empty()) {
+                run_stripes(server_index,
+                            std::move(server_stripes[server_index]));
+            }
+        }
+
+        // Every server run cancels the timer once it ends
+        while (running_count_ != 0) {
+            done_timer_.expires_at(steady_timer::time_point::max());
+            co_await done_timer_.async_wait();
+        }
+
+        if (failure_) {
+            throw std::runtime_error{*failure_};
+        }
+
+        std::vector<JobResult> results;
+        results.reserve(config_.requests().size());
+
+        for (uint64_t job_index{0}; job_index < config_.requests().size();
+             ++job_index) {
+            results.push_back(finish_job(job_index));
+        }
+
+        co_return results;
+    }
+
+    void init_stripes() {
+        const auto &requests = config_.requests();
+
+        for (uint64_t job_index{0}; job_index < requests.size(); ++job_index) {
+            split_request(job_index, requests[job_index]);
+        }
+    }
+
+    // Splits the range of a request into one closed sub-interval per server.
+    // The boundaries are representable in NumberType, so the sub-intervals
+    // stay disjoint once the servers convert them. Integer sub-intervals
+    // are as wide as the server weights allow and get number counts in
+    // proportion to their widths, which keeps every count within the unique
+    // numbers available.
+    void split_request(uint64_t job_index, const NumberRequest &request) {
+        const auto &servers = config_.servers();
+        const auto server_count = servers.size();
+        const auto total_weight = std::accumulate(
+            servers.begin(), servers.end(), 0.0,
+            [](double weight, const ServerAddress &server) {
+                return weight + server.weight;
+            });
+        const auto lower_bound =
+            request.lower_bound.value_or(-request.upper_bound);
+
+        // The lowest number of every sub-interval, followed by the end of the
+        // range, which is exclusive for integers
+        std::vector<double> boundaries(server_count + 1);
+        double cumulative_weight{0.0};
+
+        if constexpr (std::integral<NumberType>) {
+            const auto lower = std::ceil(lower_bound);
+            boundaries[server_count] =
+                std::max(std::floor(request.upper_bound) + 1, lower);
+            const auto width = boundaries[server_count] - lower;
+
+            for (size_t server_index{0}; server_index < server_count;
+                 ++server_index) {
+                boundaries[server_index] =
+                    lower +
+                    std::floor(width * (cumulative_weight / total_weight));
+                cumulative_weight += servers[server_index].weight;
+            }
+        } else {
+            boundaries[server_count] = request.upper_bound;
+
+            // Interpolated without the width of the range, which may
+            // overflow
+            for (size_t server_index{0}; server_index < server_count;
+                 ++server_index) {
+                const auto fraction = cumulative_weight / total_weight;
+                boundaries[server_index] = std::max(
+                    static_cast<double>(static_cast<NumberType>(
+                        (1.0 - fraction) * lower_bound +
+                        fraction * request.upper_bound)),
+                    server_index == 0 ? lower_bound
+                                      : boundaries[server_index - 1]);
+                cumulative_weight += servers[server_index].weight;
+            }
+        }
+
+        std::vector<double> upper_bounds(server_count);
+        std::vector<double> capacities(server_count);
+
+        for (size_t server_index{0}; server_index < server_count;
+             ++server_index) {
+            const auto next_boundary = boundaries[server_index + 1];
+
+            if constexpr (std::integral<NumberType>) {
+                // Beyond 2^53 doubles are further apart than one
+                upper_bounds[server_index] =
+                    (server_index + 1 == server_count)
+                        ? std::floor(request.upper_bound)
+                        : std::min(next_boundary - 1,
+                                   std::nextafter(next_boundary,
+                                                  -std::numeric_limits<
+                                                      double>::infinity()));
+                capacities[server_index] =
+                    next_boundary - boundaries[server_index];
+            } else {
+                upper_bounds[server_index] =
+                    (server_index + 1 == server_count)
+                        ? next_boundary
+                        : static_cast<double>(std::nextafter(
+                              static_cast<NumberType>(next_boundary),
+                              -std::numeric_limits<NumberType>::infinity()));
+                capacities[server_index] =
+                    (upper_bounds[server_index] >= boundaries[server_index])
+                        ? servers[server_index].weight
+                        : 0.0;
+            }
+        }
+
+        const auto counts = split_number_count(request.number_count,
+                                               capacities);
+
+        for (size_t server_index{server_count}; server_index-- > 0;) {
+            if (counts[server_index] == 0 && request.number_count != 0) {
+                continue;
+            }
+
+            stripes_.push_back(
+                {job_index,
+                 server_index,
+                 {counts[server_index], upper_bounds[server_index],
+                  boundaries[server_index]}});
+        }
+    }
+
+    void run_stripes(size_t server_index, std::vector<size_t> stripe_indices) {
+        ++running_count_;
+        co_spawn(strand_,
+                 serve_stripes(server_index, std::move(stripe_indices)),
+                 boost::asio::detached);
+    }
+
+    // Serves the stripes of a server on a client of its own, they are
+    // handed to the next live server if it fails
+    awaitable<void> serve_stripes(size_t server_index,
+                                  std::vector<size_t> stripe_indices) {
+        const auto &server = config_.servers()[server_index];
+        auto settings = config_.settings();
+        settings.servers = {server};
+        settings.requests.clear();
+
+        for (const auto stripe_index : stripe_indices) {
+            auto &stripe = stripes_[stripe_index];
+            stripe.server_index = server_index;
+            stripe.numbers.clear();
+            settings.requests.push_back(stripe.request);
+        }
+
+        Handlers<NumberType> handlers;
+        if (handlers_.on_sequence) {
+            handlers.on_sequence = [&](uint64_t request_id,
+                                       uint64_t sequence_index,
+                                       std::span<const NumberType> numbers) {
+                handlers_.on_sequence(
+                    stripes_[stripe_indices[request_id]].job_index,
+                    sequence_index, numbers);
+            };
+        }
+
+        handlers.on_sorted = [&](uint64_t request_id,
+                                 std::span<const NumberType> numbers) {
+            auto &stripe_numbers = stripes_[stripe_indices[request_id]].numbers;
+            stripe_numbers.insert(stripe_numbers.end(), numbers.begin(),
+                                  numbers.end());
+        };
+
+        std::optional<std::string> failure;
+
+        try {
+            UDPNumberSorterClient<Traits> client{
+                io_context_, client::Config{std::move(settings)}, {}, logger_,
+                std::move(handlers)};
+            const auto results = co_await client.async_run();
+
+            for (size_t index{0}; index < stripe_indices.size(); ++index) {
+                stripes_[stripe_indices[index]].result = results[index];
+            }
+        } catch (const std::exception &error) {
+            failure = error.what();
+        }
+
+        if (failure) {
+            logger_.log("Server {}:{} failed: {}", server.host, server.port,
+                        *failure);
+            dead_servers_[server_index] = true;
+            reassign_stripes(server_index, std::move(stripe_indices),
+                             *failure);
+        }
+
+        --running_count_;
+        done_timer_.cancel();
+    }
+
+    void reassign_stripes(size_t server_index,
+                          std::vector<size_t> stripe_indices,
+                          const std::string &failure) {
+        const auto server_count = dead_servers_.size();
+
+        for (size_t offset{1}; offset < server_count; ++offset) {
+            const auto next_server_index =
+                (server_index + offset) % server_count;
+            if (dead_servers_[next_server_index]) {
+                continue;
+            }
+
+            const auto &next_server = config_.servers()[next_server_index];
+            logger_.log("Reassigning {} stripes to server {}:{}",
+                        stripe_indices.size(), next_server.host,
+                        next_server.port);
+
+            run_stripes(next_server_index, std::move(stripe_indices));
+            return;
+        }
+
+        failure_ = std::format("No server left to serve {} stripes: {}",
+                               stripe_indices.size(), failure);
+    }
+
+    // The stripes of a job follow each other in stripes_, highest
+    // sub-interval first
+    JobResult finish_job(uint64_t job_index) {
+        JobResult result;
+        result.request_id = job_index;
+
+        std::vector<Stripe *> job_stripes;
+        for (auto &stripe : stripes_) {
+            if (stripe.job_index == job_index) {
+                job_stripes.push_back(&stripe);
+            }
+        }
+
+        for (const auto *stripe : job_stripes) {
+            if (stripe->result.error != NumberSequenceError::SEQUENCE_OK) {
+                result.error = stripe->result.error;
+                result.error_message = stripe->result.error_message;
+                return result;
+            }
+
+            result.number_count += stripe->numbers.size();
+        }
+
+        result.numbers_file_path =
+            get_numbers_file_path(numbers_file_path_, job_index);
+        if (!result.numbers_file_path.empty()) {
+            write_numbers(result, job_stripes);
+        }
+
+        for (auto *stripe : job_stripes) {
+            if (handlers_.on_sorted && !stripe->numbers.empty()) {
+                handlers_.on_sorted(job_index, stripe->numbers);
+            }
+
+            stripe->numbers = {};
+        }
+
+        return result;
+    }
+
+    void write_numbers(const JobResult &result,
+                       const std::vector<Stripe *> &job_stripes) const {
+        std::ofstream numbers_file{result.numbers_file_path,
+                                   std::ios::binary | std::ios::trunc};
+
+        if (!numbers_file) {
+            throw std::runtime_error{
+                std::format("Failed to open numbers file. Path: {}",
+                            result.numbers_file_path.string())};
+        }
+
+        const size_t numbers_size = result.number_count;
+        numbers_file.write(reinterpret_cast<const char *>(&numbers_size),
+                           sizeof(numbers_size));
+
+        for (const auto *stripe : job_stripes) {
+            numbers_file.write(
+                reinterpret_cast<const char *>(stripe->numbers.data()),
+                sizeof(NumberType) * stripe->numbers.size());
+        }
+    }
+
+private:
+    boost::asio::io_context &io_context_;
+    client::Config config_;
+    std::filesystem::path numbers_file_path_;
+    utils::Logger &logger_;
+    Handlers<NumberType> handlers_;
+    boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+    steady_timer done_timer_;
+    std::vector<bool> dead_servers_;
+    std::vector<Stripe> stripes_;
+    uint64_t running_count_{0};
+    std::optional<std::string> failure_;
+    bool started_{false};
+};
+
+// Compiled once into udp_client_core
+extern template class StripedClient<
+    utils::ElementTraits<protocol::ELEMENT_FLOAT64>>;
+extern template class StripedClient<
+    utils::ElementTraits<protocol::ELEMENT_FLOAT32>>;
+extern template class StripedClient<
+    utils::ElementTraits<protocol::ELEMENT_INT32>>;
+extern template class StripedClient<
+    utils::ElementTraits<protocol::ELEMENT_INT64>>;
+
+} // namespace client
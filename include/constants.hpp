@@ -1,6 +1,29 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 
 inline constexpr uint32_t MESSAGE_MAX_SIZE{508};
 inline constexpr uint8_t SEQUENCE_RESPONSE_MAX_RETRIES_COUNT{5};
+inline constexpr uint8_t HANDSHAKE_MAX_RETRIES_COUNT{10};
+inline constexpr uint32_t NACK_MAX_SEQUENCE_COUNT{40};
+// Keeps the missing sequences of a group within one acknowledgement
+inline constexpr uint32_t FEC_MAX_GROUP_SIZE{32};
+// CPUs a thread can be pinned to, those of a cpu_set_t
+inline constexpr uint32_t MAX_CPU_COUNT{1024};
+// Largest share of the probability the numbers of a request may take when
+// duplicates are redrawn, so that half the draws are new at worst
+inline constexpr double MAX_REJECTION_DENSITY{0.5};
+
+inline constexpr std::chrono::milliseconds INITIAL_RETRANSMISSION_TIMEOUT{250};
+inline constexpr std::chrono::milliseconds MIN_RETRANSMISSION_TIMEOUT{5};
+inline constexpr std::chrono::milliseconds MAX_RETRANSMISSION_TIMEOUT{4000};
+inline constexpr std::chrono::milliseconds HANDSHAKE_INITIAL_TIMEOUT{100};
+inline constexpr std::chrono::milliseconds SESSION_IDLE_TIMEOUT{30000};
+inline constexpr std::chrono::milliseconds SESSION_COOKIE_LIFETIME{60000};
+inline constexpr std::chrono::milliseconds MULTICAST_JOIN_WINDOW{200};
+// Longest wait of either side of a shared memory ring for the other one
+inline constexpr std::chrono::milliseconds SHARED_MEMORY_TIMEOUT{5000};
+inline constexpr std::chrono::milliseconds SHARED_MEMORY_WAIT_INTERVAL{10};
+// Threads of the server waiting for the clients to free ring slots
+inline constexpr uint32_t SHARED_MEMORY_WAITER_THREAD_COUNT{2};
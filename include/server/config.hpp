@@ -1,6 +1,10 @@
 #pragma once
 
+#include <chrono>
 #include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace server {
 
@@ -11,8 +15,83 @@ public:
 
     inline uint16_t port() const { return port_; }
 
+    inline std::optional<uint32_t> io_thread_count() const {
+        return io_thread_count_;
+    }
+    inline std::optional<uint32_t> generator_thread_count() const {
+        return generator_thread_count_;
+    }
+    inline const std::vector<uint32_t> &io_cpus() const { return io_cpus_; }
+    inline const std::vector<uint32_t> &generator_cpus() const {
+        return generator_cpus_;
+    }
+    inline std::optional<uint32_t> numa_node() const { return numa_node_; }
+    inline const std::string &network_interface() const {
+        return network_interface_;
+    }
+
+    inline const std::string &multicast_group() const {
+        return multicast_group_;
+    }
+    inline uint16_t multicast_port() const { return multicast_port_; }
+    inline const std::string &multicast_interface() const {
+        return multicast_interface_;
+    }
+    inline uint32_t multicast_rate() const { return multicast_rate_; }
+    inline uint8_t multicast_ttl() const { return multicast_ttl_; }
+
+    // Admission limits, zero disables a limit
+    inline uint32_t max_session_count() const { return max_session_count_; }
+    inline uint64_t max_numbers_in_flight() const {
+        return max_numbers_in_flight_;
+    }
+    inline double client_rate() const { return client_rate_; }
+    inline double client_burst() const { return client_burst_; }
+    inline uint32_t admission_queue_size() const {
+        return admission_queue_size_;
+    }
+    inline std::chrono::milliseconds admission_queue_timeout() const {
+        return admission_queue_timeout_;
+    }
+    inline std::chrono::milliseconds retry_after() const {
+        return retry_after_;
+    }
+
+    // Largest forward error correction group granted, zero disables it
+    inline uint32_t fec_max_group_size() const { return fec_max_group_size_; }
+
+    // Shared memory ring offered to clients on the same host, zero slots
+    // disable it
+    inline uint32_t shared_memory_slot_count() const {
+        return shared_memory_slot_count_;
+    }
+    inline uint64_t shared_memory_sequence_size() const {
+        return shared_memory_sequence_size_;
+    }
+
 private:
     uint16_t port_{};
+    std::optional<uint32_t> io_thread_count_;
+    std::optional<uint32_t> generator_thread_count_;
+    std::vector<uint32_t> io_cpus_;
+    std::vector<uint32_t> generator_cpus_;
+    std::optional<uint32_t> numa_node_;
+    std::string network_interface_;
+    std::string multicast_group_;
+    uint16_t multicast_port_{};
+    std::string multicast_interface_;
+    uint32_t multicast_rate_{};
+    uint8_t multicast_ttl_{};
+    uint32_t max_session_count_{};
+    uint64_t max_numbers_in_flight_{};
+    double client_rate_{};
+    double client_burst_{};
+    uint32_t admission_queue_size_{};
+    std::chrono::milliseconds admission_queue_timeout_{};
+    std::chrono::milliseconds retry_after_{};
+    uint32_t fec_max_group_size_{};
+    uint32_t shared_memory_slot_count_{};
+    uint64_t shared_memory_sequence_size_{};
 };
 
 } // namespace server
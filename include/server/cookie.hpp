@@ -0,0 +1,139 @@
+#pragma once
+
+#include <boost/asio/ip/udp.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <span>
+
+namespace server {
+
+// Issues and verifies the stateless session cookies of the handshake. A
+// cookie is a SipHash-2-4 MAC of the client endpoint and the current
+// lifetime window under a key drawn at startup, so nothing is stored for
+// clients that never echo it and spoofed sources cannot forge one. Cookies
+// issued in the previous window are still accepted.
+class CookieGenerator {
+public:
+    explicit CookieGenerator(std::chrono::steady_clock::duration lifetime)
+        : lifetime_{lifetime} {
+        std::random_device device;
+        for (auto &key_word : key_) {
+            key_word = (uint64_t{device()} << 32) | device();
+        }
+    }
+
+    uint64_t issue(const boost::asio::ip::udp::endpoint &endpoint) const {
+        return make_cookie(endpoint, get_window());
+    }
+
+    bool verify(uint64_t cookie,
+                const boost::asio::ip::udp::endpoint &endpoint) const {
+        const auto window = get_window();
+
+        return cookie == make_cookie(endpoint, window) ||
+               (window != 0 && cookie == make_cookie(endpoint, window - 1));
+    }
+
+private:
+    uint64_t get_window() const {
+        return static_cast<uint64_t>(
+            std::chrono::steady_clock::now().time_since_epoch() / lifetime_);
+    }
+
+    // The message is the IPv6 (or IPv4-mapped) address, the port and the
+    // window
+    uint64_t make_cookie(const boost::asio::ip::udp::endpoint &endpoint,
+                         uint64_t window) const {
+        std::array<uint8_t, 26> message{};
+
+        const auto address = endpoint.address();
+        if (address.is_v4()) {
+            const auto bytes = address.to_v4().to_bytes();
+            message[10] = 0xff;
+            message[11] = 0xff;
+            std::ranges::copy(bytes, message.begin() + 12);
+        } else {
+            std::ranges::copy(address.to_v6().to_bytes(), message.begin());
+        }
+
+        message[16] = static_cast<uint8_t>(endpoint.port() >> 8);
+        message[17] = static_cast<uint8_t>(endpoint.port());
+
+        for (size_t byte_index{0}; byte_index < 8; ++byte_index) {
+            message[18 + byte_index] =
+                static_cast<uint8_t>(window >> (byte_index * 8));
+        }
+
+        return siphash(message);
+    }
+
+    uint64_t siphash(std::span<const uint8_t> message) const {
+        uint64_t v0{key_[0] ^ 0x736f6d6570736575};
+        uint64_t v1{key_[1] ^ 0x646f72616e646f6d};
+        uint64_t v2{key_[0] ^ 0x6c7967656e657261};
+        uint64_t v3{key_[1] ^ 0x7465646279746573};
+
+        const auto round = [&] {
+            v0 += v1;
+            v1 = std::rotl(v1, 13);
+            v1 ^= v0;
+            v0 = std::rotl(v0, 32);
+            v2 += v3;
+            v3 = std::rotl(v3, 16);
+            v3 ^= v2;
+            v0 += v3;
+            v3 = std::rotl(v3, 21);
+            v3 ^= v0;
+            v2 += v1;
+            v1 = std::rotl(v1, 17);
+            v1 ^= v2;
+            v2 = std::rotl(v2, 32);
+        };
+
+        const auto compress = [&](uint64_t word) {
+            v3 ^= word;
+            round();
+            round();
+            v0 ^= word;
+        };
+
+        // Words are read little-endian, the last one carries the remaining
+        // bytes and the message length in its top byte
+        const auto word_count = message.size() / 8;
+        for (size_t word_index{0}; word_index < word_count; ++word_index) {
+            uint64_t word{0};
+            for (size_t byte_index{0}; byte_index < 8; ++byte_index) {
+                word |= uint64_t{message[word_index * 8 + byte_index]}
+                        << (byte_index * 8);
+            }
+
+            compress(word);
+        }
+
+        uint64_t last_word{uint64_t{message.size()} << 56};
+        for (size_t byte_index{0}; byte_index < message.size() % 8;
+             ++byte_index) {
+            last_word |= uint64_t{message[word_count * 8 + byte_index]}
+                         << (byte_index * 8);
+        }
+
+        compress(last_word);
+
+        v2 ^= 0xff;
+        for (size_t round_index{0}; round_index < 4; ++round_index) {
+            round();
+        }
+
+        return v0 ^ v1 ^ v2 ^ v3;
+    }
+
+    std::chrono::steady_clock::duration lifetime_;
+    std::array<uint64_t, 2> key_{};
+};
+
+} // namespace server
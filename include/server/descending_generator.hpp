@@ -0,0 +1,96 @@
+#pragma once
+
+#include "server/philox.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <random>
+
+namespace server {
+
+// Generates a uniformly distributed sample directly in descending order, one
+// number at a time and in constant memory (Bentley and Saxe, "Generating
+// sorted lists of random numbers"). The maximum of k uniform numbers on
+// [0, 1] is distributed as U^(1/k), so each number is the previous one scaled
+// by a fresh U^(1/k), where k is the count of numbers still to generate.
+// The uniform variate of every number is drawn from its own counter-based
+// stream, so a copy of the generator regenerates the numbers that followed.
+template <typename NumberType> class DescendingUniformGenerator {
+public:
+    DescendingUniformGenerator(NumberType lower_bound, NumberType upper_bound,
+                               uint64_t number_count, uint64_t seed)
+        : seed_{seed}, lower_bound_{lower_bound}, upper_bound_{upper_bound},
+          number_count_{number_count}, state_{number_count} {}
+
+    inline uint64_t remaining_count() const { return state_.remaining_count; }
+
+    NumberType operator()() {
+        CounterEngine engine{seed_, number_count_ - state_.remaining_count};
+
+        // log1p(-u) is log(1 - u), which avoids log(0) for u == 0
+        state_.log_fraction += std::log1p(-distribution_(engine)) /
+                               static_cast<double>(state_.remaining_count);
+        --state_.remaining_count;
+
+        const auto lower_bound = static_cast<double>(lower_bound_);
+        const auto upper_bound = static_cast<double>(upper_bound_);
+        const auto &previous_number = state_.previous_number;
+        NumberType number;
+
+        if constexpr (std::integral<NumberType>) {
+            // Integers are drawn from [lower_bound, upper_bound + 1) and
+            // floored. Neighbours falling on the same integer are pushed
+            // down, leaving room for the numbers still to generate.
+            const auto sample =
+                lower_bound + (upper_bound - lower_bound + 1.0) *
+                                  std::exp(state_.log_fraction);
+            number = static_cast<NumberType>(
+                std::min(std::floor(sample), upper_bound));
+
+            if (previous_number && number >= *previous_number) {
+                number = *previous_number - 1;
+            }
+
+            const auto lowest_number = static_cast<NumberType>(
+                lower_bound_ + static_cast<NumberType>(state_.remaining_count));
+            number = std::max(number, lowest_number);
+        } else {
+            number = static_cast<NumberType>(
+                lower_bound +
+                (upper_bound - lower_bound) * std::exp(state_.log_fraction));
+
+            // Rounding may produce equal neighbours in very large samples,
+            // the sample is kept strictly descending so its numbers stay
+            // unique
+            if (previous_number && number >= *previous_number) {
+                number = std::nextafter(
+                    *previous_number,
+                    -std::numeric_limits<NumberType>::infinity());
+            }
+        }
+
+        state_.previous_number = number;
+
+        return number;
+    }
+
+private:
+    struct State {
+        uint64_t remaining_count{};
+        double log_fraction{0.0};
+        std::optional<NumberType> previous_number;
+    };
+
+    uint64_t seed_;
+    std::uniform_real_distribution<double> distribution_{0.0, 1.0};
+    NumberType lower_bound_;
+    NumberType upper_bound_;
+    uint64_t number_count_;
+    State state_;
+};
+
+} // namespace server
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace server {
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel random
+// numbers: as easy as 1, 2, 3"). Every 128-bit counter is encrypted
+// independently under a 64-bit key, so any part of a stream can be produced
+// on any thread and in any order without shared state.
+class Philox4x32 {
+public:
+    using Counter = std::array<uint32_t, 4>;
+    using Key = std::array<uint32_t, 2>;
+
+    static Counter generate(Counter counter, Key key) {
+        for (uint32_t round_index{0}; round_index < ROUND_COUNT;
+             ++round_index) {
+            const auto product0 = uint64_t{MULTIPLIER0} * counter[0];
+            const auto product1 = uint64_t{MULTIPLIER1} * counter[2];
+
+            counter = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^
+                           key[0],
+                       static_cast<uint32_t>(product1),
+                       static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^
+                           key[1],
+                       static_cast<uint32_t>(product0)};
+
+            key[0] += WEYL0;
+            key[1] += WEYL1;
+        }
+
+        return counter;
+    }
+
+private:
+    static constexpr uint32_t ROUND_COUNT{10};
+    static constexpr uint32_t MULTIPLIER0{0xD2511F53};
+    static constexpr uint32_t MULTIPLIER1{0xCD9E8D57};
+    static constexpr uint32_t WEYL0{0x9E3779B9};
+    static constexpr uint32_t WEYL1{0xBB67AE85};
+};
+
+// Uniform random bit generator over the stream of one number: the key is
+// the transfer seed, the counter holds the number index and the draw index.
+// Numbers are regenerated exactly by recreating the engine and drawing
+// again, which makes it usable with the standard distributions.
+class CounterEngine {
+public:
+    using result_type = uint64_t;
+
+    CounterEngine(uint64_t seed, uint64_t number_index)
+        : key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+          number_index_{number_index} {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()() {
+        if (block_offset_ == block_.size()) {
+            block_ = Philox4x32::generate(
+                {block_index_++, 0, static_cast<uint32_t>(number_index_),
+                 static_cast<uint32_t>(number_index_ >> 32)},
+                key_);
+            block_offset_ = 0;
+        }
+
+        const auto low = block_[block_offset_++];
+        const auto high = block_[block_offset_++];
+
+        return (uint64_t{high} << 32) | low;
+    }
+
+private:
+    Philox4x32::Key key_;
+    uint64_t number_index_;
+    uint32_t block_index_{0};
+    Philox4x32::Counter block_{};
+    size_t block_offset_{block_.size()};
+};
+
+} // namespace server
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "server/philox.hpp"
+#include "server/samplers.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace server {
+
+// Draws distinct offsets of [0, range) exactly, by a partial Fisher-Yates
+// shuffle, for integer requests too dense for rejection. Number i swaps
+// position i with a uniform position of [i, range) drawn from the
+// counter-based stream of number i. Only the positions whose offset was
+// swapped are kept, so memory grows with the numbers drawn rather than with
+// the range. Positions below the draw count are final and are read back to
+// regenerate their numbers.
+class RangeShuffle {
+public:
+    RangeShuffle(uint64_t range, uint64_t seed) : seed_{seed}, range_{range} {}
+
+    inline uint64_t drawn_count() const { return drawn_count_; }
+
+    // Draws the offset of number drawn_count()
+    uint64_t operator()() {
+        const auto number_index = drawn_count_++;
+        CounterEngine engine{seed_, number_index};
+        const auto position =
+            number_index +
+            draw(UniformSampler<uint64_t>{0, range_ - number_index - 1},
+                 engine);
+
+        const auto offset = get(position);
+        if (position != number_index) {
+            swapped_offsets_.insert_or_assign(position, get(number_index));
+        }
+
+        swapped_offsets_.insert_or_assign(number_index, offset);
+
+        return offset;
+    }
+
+    // The offset at a position, that of the number drawn there once the
+    // position is below the draw count
+    uint64_t get(uint64_t position) const {
+        const auto offset = swapped_offsets_.find(position);
+        return (offset == swapped_offsets_.end()) ? position : offset->second;
+    }
+
+    // Forgets a number drawn, which is not regenerated any more
+    void release(uint64_t number_index) {
+        swapped_offsets_.erase(number_index);
+    }
+
+private:
+    uint64_t seed_;
+    uint64_t range_;
+    uint64_t drawn_count_{0};
+    std::unordered_map<uint64_t, uint64_t> swapped_offsets_;
+};
+
+} // namespace server
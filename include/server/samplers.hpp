@@ -0,0 +1,352 @@
+#pragma once
+
+#include "server/philox.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <tuple>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace server {
+
+namespace sampling {
+
+inline constexpr size_t BATCH_SIZE{256};
+
+// Uniform double in [0, 1) from the upper 53 bits of a word
+inline double to_unit(uint64_t word) {
+    return static_cast<double>(word >> 11) * 0x1.0p-53;
+}
+
+// Returns the high half of the 128-bit product and stores the low half
+inline uint64_t multiply_high(uint64_t first, uint64_t second,
+                              uint64_t &low) {
+#if defined(_MSC_VER)
+    uint64_t high;
+    low = _umul128(first, second, &high);
+    return high;
+#else
+    const auto product = static_cast<unsigned __int128>(first) * second;
+    low = static_cast<uint64_t>(product);
+    return static_cast<uint64_t>(product >> 64);
+#endif
+}
+
+// Real interval the samples are drawn from, integers taking the samples
+// in [number, number + 1)
+template <typename NumberType>
+std::pair<double, double> get_sample_bounds(NumberType lower_bound,
+                                            NumberType upper_bound) {
+    if constexpr (std::integral<NumberType>) {
+        return {static_cast<double>(lower_bound),
+                static_cast<double>(upper_bound) + 1.0};
+    } else {
+        return {static_cast<double>(lower_bound),
+                static_cast<double>(upper_bound)};
+    }
+}
+
+// Integers are rounded down. Rounding may cross a bound by one step, the
+// result is kept within the bounds.
+template <typename NumberType>
+NumberType to_number(double sample, NumberType lower_bound,
+                     NumberType upper_bound) {
+    if constexpr (std::integral<NumberType>) {
+        return static_cast<NumberType>(
+            std::floor(std::clamp(sample, static_cast<double>(lower_bound),
+                                  static_cast<double>(upper_bound))));
+    } else {
+        return std::clamp(static_cast<NumberType>(sample), lower_bound,
+                          upper_bound);
+    }
+}
+
+// Largest gap between neighbouring numbers of the range, the real interval
+// any single number is drawn from at most
+template <typename NumberType>
+double get_max_spacing(NumberType lower_bound, NumberType upper_bound) {
+    if constexpr (std::integral<NumberType>) {
+        return 1.0;
+    } else {
+        const auto magnitude =
+            std::max(std::abs(lower_bound), std::abs(upper_bound));
+        if (magnitude == 0) {
+            return std::numeric_limits<NumberType>::denorm_min();
+        }
+
+        return std::max(
+            std::ldexp(1.0, std::ilogb(magnitude) -
+                                std::numeric_limits<NumberType>::digits + 1),
+            static_cast<double>(std::numeric_limits<NumberType>::denorm_min()));
+    }
+}
+
+} // namespace sampling
+
+// A sampler turns two words of a number stream into a number, or rejects
+// them, in which case the next two words are tried. The distribution
+// parameters are derived once per transfer, and transform reports a
+// rejection instead of retrying, so that sample_batch runs it as a flat loop
+// over a whole sequence. That loop is not vectorised: the 128-bit products,
+// log, sqrt and cos have no vector form without a vector math library.
+template <typename NumberType> class UniformSampler;
+
+// Lemire's method ("Fast random integer generation in an interval"), with
+// the rejection threshold computed once, so that no draw divides
+template <std::integral NumberType> class UniformSampler<NumberType> {
+public:
+    using value_type = NumberType;
+
+    UniformSampler(NumberType lower_bound, NumberType upper_bound)
+        : lower_bound_{lower_bound},
+          range_{static_cast<uint64_t>(upper_bound) -
+                 static_cast<uint64_t>(lower_bound) + 1},
+          threshold_{range_ == 0 ? 0 : (0 - range_) % range_} {}
+
+    // Probability of the most likely number, which bounds how many distinct
+    // numbers rejection finds cheaply
+    double max_probability() const {
+        return (range_ == 0) ? 0x1.0p-64 : 1.0 / static_cast<double>(range_);
+    }
+
+    bool transform(uint64_t first_word, uint64_t, NumberType &number) const {
+        uint64_t low;
+        const auto high = sampling::multiply_high(first_word, range_, low);
+
+        // A range of zero stands for all 2^64 values
+        const auto offset = (range_ == 0) ? first_word : high;
+        number = static_cast<NumberType>(
+            static_cast<uint64_t>(lower_bound_) + offset);
+
+        return low >= threshold_;
+    }
+
+private:
+    NumberType lower_bound_;
+    uint64_t range_;
+    uint64_t threshold_;
+};
+
+template <std::floating_point NumberType> class UniformSampler<NumberType> {
+public:
+    using value_type = NumberType;
+
+    UniformSampler(NumberType lower_bound, NumberType upper_bound)
+        : lower_bound_{lower_bound}, upper_bound_{upper_bound} {}
+
+    // A number takes at most the largest spacing of the range and one more
+    // step of the 53-bit unit
+    double max_probability() const {
+        const auto width = static_cast<double>(upper_bound_) -
+                           static_cast<double>(lower_bound_);
+        if (!(width > 0)) {
+            return 1.0;
+        }
+
+        return std::min(
+            sampling::get_max_spacing(lower_bound_, upper_bound_) / width +
+                0x1.0p-53,
+            1.0);
+    }
+
+    bool transform(uint64_t first_word, uint64_t, NumberType &number) const {
+        const auto unit = sampling::to_unit(first_word);
+
+        // Interpolated without the width of the range, which may overflow
+        number = sampling::to_number(
+            (1.0 - unit) * lower_bound_ + unit * upper_bound_, lower_bound_,
+            upper_bound_);
+
+        return true;
+    }
+
+private:
+    NumberType lower_bound_;
+    NumberType upper_bound_;
+};
+
+// Normal distribution centred on the range, with three standard deviations
+// to either bound, truncated to the range. Box-Muller turns the two words
+// into a normal variate; the 0.3% falling outside the range are rejected.
+template <typename NumberType> class NormalSampler {
+public:
+    using value_type = NumberType;
+
+    NormalSampler(NumberType lower_bound, NumberType upper_bound)
+        : lower_bound_{lower_bound}, upper_bound_{upper_bound} {
+        std::tie(sample_lower_bound_, sample_upper_bound_) =
+            sampling::get_sample_bounds(lower_bound, upper_bound);
+        mean_ = sample_lower_bound_ / 2 + sample_upper_bound_ / 2;
+        deviation_ = (sample_upper_bound_ / 2 - sample_lower_bound_ / 2) / 3;
+    }
+
+    // The density at the mean over the largest spacing, scaled up by the
+    // mass the truncation keeps
+    double max_probability() const {
+        if (!(deviation_ > 0)) {
+            return 1.0;
+        }
+
+        return std::min(
+            sampling::get_max_spacing(lower_bound_, upper_bound_) /
+                (deviation_ * std::sqrt(2.0 * std::numbers::pi) * MASS),
+            1.0);
+    }
+
+    bool transform(uint64_t first_word, uint64_t second_word,
+                   NumberType &number) const {
+        // 1 - u lies in (0, 1], so the logarithm is finite
+        const auto radius = std::sqrt(
+            -2.0 * std::log(1.0 - sampling::to_unit(first_word)));
+        const auto angle =
+            2.0 * std::numbers::pi * sampling::to_unit(second_word);
+        const auto sample = mean_ + deviation_ * radius * std::cos(angle);
+
+        number = sampling::to_number(sample, lower_bound_, upper_bound_);
+
+        if constexpr (std::integral<NumberType>) {
+            return (sample >= sample_lower_bound_) &
+                   (sample < sample_upper_bound_);
+        } else {
+            return (sample >= sample_lower_bound_) &
+                   (sample <= sample_upper_bound_);
+        }
+    }
+
+private:
+    // Mass of the distribution within three standard deviations
+    static constexpr double MASS{0.9973};
+
+    NumberType lower_bound_;
+    NumberType upper_bound_;
+    double sample_lower_bound_{};
+    double sample_upper_bound_{};
+    double mean_{};
+    double deviation_{};
+};
+
+// Exponential distribution decaying from the lower bound with a scale of a
+// quarter of the range, truncated to the range. The truncated distribution
+// function is inverted directly, so no draw is rejected.
+template <typename NumberType> class ExponentialSampler {
+public:
+    using value_type = NumberType;
+
+    ExponentialSampler(NumberType lower_bound, NumberType upper_bound)
+        : lower_bound_{lower_bound}, upper_bound_{upper_bound} {
+        double sample_upper_bound;
+        std::tie(sample_lower_bound_, sample_upper_bound) =
+            sampling::get_sample_bounds(lower_bound, upper_bound);
+        scale_ = (sample_upper_bound / 2 - sample_lower_bound_ / 2) /
+                 (SCALE_COUNT / 2);
+    }
+
+    // The density at the lower bound over the largest spacing
+    double max_probability() const {
+        if (!(scale_ > 0)) {
+            return 1.0;
+        }
+
+        return std::min(sampling::get_max_spacing(lower_bound_, upper_bound_) /
+                            (scale_ * MASS),
+                        1.0);
+    }
+
+    bool transform(uint64_t first_word, uint64_t, NumberType &number) const {
+        const auto sample =
+            sample_lower_bound_ -
+            scale_ * std::log1p(-MASS * sampling::to_unit(first_word));
+
+        number = sampling::to_number(sample, lower_bound_, upper_bound_);
+
+        return true;
+    }
+
+private:
+    // The range spans SCALE_COUNT scales, holding MASS of the distribution
+    static constexpr double SCALE_COUNT{4.0};
+    static inline const double MASS{-std::expm1(-SCALE_COUNT)};
+
+    NumberType lower_bound_;
+    NumberType upper_bound_;
+    double sample_lower_bound_{};
+    double scale_{};
+};
+
+// Draws the next number of a stream
+template <typename Sampler>
+typename Sampler::value_type draw(const Sampler &sampler,
+                                  CounterEngine &engine) {
+    typename Sampler::value_type number{};
+
+    for (;;) {
+        const auto first_word = engine();
+        const auto second_word = engine();
+
+        if (sampler.transform(first_word, second_word, number)) {
+            return number;
+        }
+    }
+}
+
+// Fills numbers[i] with the first draw of the stream of number
+// first_number_index + i. The first block of every stream is generated for
+// a batch of numbers, a loop the compiler vectorises across the counters,
+// and transformed in a separate loop; the few numbers whose first words are
+// rejected are then drawn one at a time.
+template <typename Sampler>
+void sample_batch(const Sampler &sampler,
+                  std::span<typename Sampler::value_type> numbers,
+                  uint64_t seed, uint64_t first_number_index) {
+    const Philox4x32::Key key{static_cast<uint32_t>(seed),
+                              static_cast<uint32_t>(seed >> 32)};
+    std::array<uint64_t, sampling::BATCH_SIZE> first_words;
+    std::array<uint64_t, sampling::BATCH_SIZE> second_words;
+    std::array<bool, sampling::BATCH_SIZE> accepted;
+
+    for (size_t batch_begin{0}; batch_begin < numbers.size();
+         batch_begin += sampling::BATCH_SIZE) {
+        const auto batch = numbers.subspan(
+            batch_begin,
+            std::min(sampling::BATCH_SIZE, numbers.size() - batch_begin));
+        const auto batch_number_index = first_number_index + batch_begin;
+
+        // The layout of CounterEngine: block zero of the stream, the low
+        // word of each draw first
+        for (size_t index{0}; index < batch.size(); ++index) {
+            const auto number_index = batch_number_index + index;
+            const auto block = Philox4x32::generate(
+                {0, 0, static_cast<uint32_t>(number_index),
+                 static_cast<uint32_t>(number_index >> 32)},
+                key);
+
+            first_words[index] = (uint64_t{block[1]} << 32) | block[0];
+            second_words[index] = (uint64_t{block[3]} << 32) | block[2];
+        }
+
+        for (size_t index{0}; index < batch.size(); ++index) {
+            accepted[index] = sampler.transform(
+                first_words[index], second_words[index], batch[index]);
+        }
+
+        for (size_t index{0}; index < batch.size(); ++index) {
+            if (!accepted[index]) {
+                CounterEngine engine{seed, batch_number_index + index};
+                batch[index] = draw(sampler, engine);
+            }
+        }
+    }
+}
+
+} // namespace server
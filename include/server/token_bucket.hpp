@@ -0,0 +1,50 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+namespace server {
+
+// Limits the request rate of a client. The bucket holds up to burst tokens
+// and is refilled at rate tokens per second, every admitted request takes a
+// token.
+class TokenBucket {
+public:
+    using clock = std::chrono::steady_clock;
+
+    TokenBucket(double rate, double burst, clock::time_point now)
+        : rate_{rate}, burst_{burst}, tokens_{burst}, refill_time_{now} {}
+
+    // Takes a token if one is available, otherwise returns how long it takes
+    // for one to become available
+    clock::duration take(clock::time_point now) {
+        tokens_ = get_tokens(now);
+        refill_time_ = now;
+
+        if (tokens_ >= 1.0) {
+            tokens_ -= 1.0;
+            return clock::duration::zero();
+        }
+
+        return std::chrono::ceil<clock::duration>(
+            std::chrono::duration<double>{(1.0 - tokens_) / rate_});
+    }
+
+    // A full bucket behaves like a new one and can be dropped
+    bool is_full(clock::time_point now) const {
+        return get_tokens(now) >= burst_;
+    }
+
+private:
+    double get_tokens(clock::time_point now) const {
+        const std::chrono::duration<double> elapsed{now - refill_time_};
+        return std::min(burst_, tokens_ + rate_ * elapsed.count());
+    }
+
+    double rate_;
+    double burst_;
+    double tokens_;
+    clock::time_point refill_time_;
+};
+
+} // namespace server
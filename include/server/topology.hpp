@@ -0,0 +1,52 @@
+#pragma once
+
+#include "server/config.hpp"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace server {
+
+// Placement of the server threads. Values missing from the config are
+// derived from the network interface: I/O threads go to the cores that
+// service the NIC interrupts, generator threads to the remaining cores of
+// the NIC's NUMA node, and thread memory is preferably allocated on that
+// node.
+class ThreadTopology {
+public:
+    ThreadTopology(const Config &config);
+
+    inline uint32_t io_thread_count() const { return io_thread_count_; }
+    inline uint32_t generator_thread_count() const {
+        return generator_thread_count_;
+    }
+    inline const std::vector<uint32_t> &io_cpus() const { return io_cpus_; }
+    inline const std::vector<uint32_t> &generator_cpus() const {
+        return generator_cpus_;
+    }
+    inline std::optional<uint32_t> numa_node() const { return numa_node_; }
+
+    // Pins the calling thread and sets its memory policy. Returns false if
+    // the platform does not support part of the placement.
+    bool apply_to_io_thread(uint32_t thread_index) const;
+    bool apply_to_generator_thread(uint32_t thread_index) const;
+
+    // Parses lists such as "0-3,8" as found in sysfs. Throws if a range is
+    // malformed, reversed or beyond MAX_CPU_COUNT.
+    static std::vector<uint32_t> parse_cpu_list(std::string_view cpu_list);
+    static std::string format_cpu_list(const std::vector<uint32_t> &cpus);
+
+private:
+    bool apply_to_thread(const std::vector<uint32_t> &cpus,
+                         uint32_t thread_index) const;
+
+    uint32_t io_thread_count_{};
+    uint32_t generator_thread_count_{};
+    std::vector<uint32_t> io_cpus_;
+    std::vector<uint32_t> generator_cpus_;
+    std::optional<uint32_t> numa_node_;
+};
+
+} // namespace server
@@ -1,14 +1,31 @@
 #pragma once
 
+#include <bit>
+#include <concepts>
 #include <cstdint>
+#include <type_traits>
 
 namespace utils {
 
+// Floating-point numbers are represented by their bit pattern, which is exact
+// and well defined for negative values, integers by their two's complement
+// value.
+template <typename NumberType> uint64_t get_bit_pattern(NumberType number) {
+    if constexpr (std::same_as<NumberType, float>) {
+        return std::bit_cast<uint32_t>(number);
+    } else if constexpr (std::same_as<NumberType, double>) {
+        return std::bit_cast<uint64_t>(number);
+    } else {
+        static_assert(std::integral<NumberType>);
+        return static_cast<uint64_t>(number);
+    }
+}
+
 uint64_t calculate_checksum(const auto &numbers) {
     uint64_t checksum{0};
 
     for (const auto &number : numbers) {
-        checksum += number;
+        checksum += get_bit_pattern(number);
     }
 
     return checksum;
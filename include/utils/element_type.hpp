@@ -0,0 +1,107 @@
+#pragma once
+
+#include "protocol.pb.h"
+
+#include <cstdint>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+
+namespace utils {
+
+// Maps an element type of the protocol to its C++ type and to the repeated
+// field of NumberSequenceResponse carrying it. Code templated on the traits
+// is dispatched once per sequence or session through visit_element_type.
+template <protocol::ElementType Type> struct ElementTraits;
+
+template <> struct ElementTraits<protocol::ELEMENT_FLOAT64> {
+    using value_type = double;
+    static constexpr std::string_view name{"float64"};
+
+    static const auto &
+    numbers(const protocol::NumberSequenceResponse &response) {
+        return response.numbers();
+    }
+
+    static auto *mutable_numbers(protocol::NumberSequenceResponse &response) {
+        return response.mutable_numbers();
+    }
+};
+
+template <> struct ElementTraits<protocol::ELEMENT_FLOAT32> {
+    using value_type = float;
+    static constexpr std::string_view name{"float32"};
+
+    static const auto &
+    numbers(const protocol::NumberSequenceResponse &response) {
+        return response.float32_numbers();
+    }
+
+    static auto *mutable_numbers(protocol::NumberSequenceResponse &response) {
+        return response.mutable_float32_numbers();
+    }
+};
+
+template <> struct ElementTraits<protocol::ELEMENT_INT32> {
+    using value_type = int32_t;
+    static constexpr std::string_view name{"int32"};
+
+    static const auto &
+    numbers(const protocol::NumberSequenceResponse &response) {
+        return response.int32_numbers();
+    }
+
+    static auto *mutable_numbers(protocol::NumberSequenceResponse &response) {
+        return response.mutable_int32_numbers();
+    }
+};
+
+template <> struct ElementTraits<protocol::ELEMENT_INT64> {
+    using value_type = int64_t;
+    static constexpr std::string_view name{"int64"};
+
+    static const auto &
+    numbers(const protocol::NumberSequenceResponse &response) {
+        return response.int64_numbers();
+    }
+
+    static auto *mutable_numbers(protocol::NumberSequenceResponse &response) {
+        return response.mutable_int64_numbers();
+    }
+};
+
+template <typename Visitor>
+decltype(auto) visit_element_type(protocol::ElementType element_type,
+                                  Visitor &&visitor) {
+    switch (element_type) {
+    case protocol::ELEMENT_FLOAT64:
+        return visitor(ElementTraits<protocol::ELEMENT_FLOAT64>{});
+    case protocol::ELEMENT_FLOAT32:
+        return visitor(ElementTraits<protocol::ELEMENT_FLOAT32>{});
+    case protocol::ELEMENT_INT32:
+        return visitor(ElementTraits<protocol::ELEMENT_INT32>{});
+    case protocol::ELEMENT_INT64:
+        return visitor(ElementTraits<protocol::ELEMENT_INT64>{});
+    default:
+        throw std::invalid_argument{std::format(
+            "Unsupported element type: {}", static_cast<int>(element_type))};
+    }
+}
+
+inline protocol::ElementType parse_element_type(std::string_view name) {
+    for (const auto element_type :
+         {protocol::ELEMENT_FLOAT64, protocol::ELEMENT_FLOAT32,
+          protocol::ELEMENT_INT32, protocol::ELEMENT_INT64}) {
+        const auto element_name = visit_element_type(
+            element_type, [](auto traits) { return traits.name; });
+
+        if (element_name == name) {
+            return element_type;
+        }
+    }
+
+    throw std::invalid_argument{
+        std::format("Unsupported element type: {}", name)};
+}
+
+} // namespace utils
@@ -3,6 +3,7 @@
 #include <sstream>
 
 #include "protocol.pb.h"
+#include "utils/element_type.hpp"
 
 template <>
 struct std::formatter<protocol::ProtocolVersionRequest>
@@ -13,6 +14,7 @@ struct std::formatter<protocol::ProtocolVersionRequest>
         std::ostringstream request_stream;
         request_stream << "{ "
                        << "protocol_version: " << request.protocol_version()
+                       << ", shared_memory: " << request.shared_memory()
                        << " }";
 
         return std::formatter<std::string>::format(request_stream.str(),
@@ -31,7 +33,9 @@ struct std::formatter<protocol::ProtocolVersionResponse>
                         << "protocol_version: " << response.protocol_version()
                         << ", error: " << response.error()
                         << ", error_message: \"" << response.error_message()
-                        << "\" }";
+                        << "\", session_token: " << response.session_token()
+                        << ", shared_memory: " << response.shared_memory()
+                        << " }";
 
         return std::formatter<std::string>::format(response_stream.str(),
                                                    context);
@@ -46,7 +50,18 @@ struct std::formatter<protocol::NumberSequenceRequest>
                 FormatContext &context) const {
         std::ostringstream request_stream;
         request_stream << "{ " << "number_count: " << request.number_count()
-                       << ", upper_bound: " << request.upper_bound() << " }";
+                       << ", upper_bound: " << request.upper_bound();
+        if (request.has_lower_bound()) {
+            request_stream << ", lower_bound: " << request.lower_bound();
+        }
+        request_stream << ", order: " << request.order()
+                       << ", element_type: " << request.element_type()
+                       << ", distribution: " << request.distribution()
+                       << ", shared_memory: " << request.shared_memory()
+                       << ", session_token: " << request.session_token()
+                       << ", request_id: " << request.request_id()
+                       << ", fec_group_size: " << request.fec_group_size()
+                       << " }";
 
         return std::formatter<std::string>::format(request_stream.str(),
                                                    context);
@@ -60,28 +75,37 @@ struct std::formatter<protocol::NumberSequenceResponse>
     auto format(const protocol::NumberSequenceResponse &response,
                 FormatContext &context) const {
         std::ostringstream response_stream;
-        response_stream << "{ " << "number_count: " << response.number_count()
+        response_stream << "{ " << "request_id: " << response.request_id()
+                        << ", stream_id: " << response.stream_id()
+                        << ", number_count: " << response.number_count()
                         << ", sequence_index: " << response.sequence_index()
                         << ", sequence_count: " << response.sequence_count()
+                        << ", order: " << response.order()
+                        << ", element_type: " << response.element_type()
                         << ", sequence_number_count: "
                         << response.sequence_number_count() << ", numbers: [";
 
         // response_stream << "...";
 
-        const auto &numbers = response.numbers();
-        if (!numbers.empty()) {
-            response_stream << numbers[0];
-            for (const auto &number : numbers | std::views::drop(1)) {
-                {
-                    response_stream << ", " << number;
+        utils::visit_element_type(
+            response.element_type(), [&]<typename Traits>(Traits) {
+                const auto &numbers = Traits::numbers(response);
+                if (!numbers.empty()) {
+                    response_stream << numbers[0];
+                    for (const auto &number : numbers | std::views::drop(1)) {
+                        {
+                            response_stream << ", " << number;
+                        }
+                    }
                 }
-            }
-        }
+            });
 
         response_stream << "]" << ", checksum: " << response.checksum()
                         << ", error: " << response.error()
                         << ", error_message: \"" << response.error_message()
-                        << "\" }";
+                        << "\", retry_after_ms: " << response.retry_after_ms()
+                        << ", fec_group_size: " << response.fec_group_size()
+                        << " }";
 
         return std::formatter<std::string>::format(response_stream.str(),
                                                    context);
@@ -97,9 +121,167 @@ struct std::formatter<protocol::NumberSequenceAckRequest>
         std::ostringstream request_stream;
         request_stream << "{" << " sequence_index: " << request.sequence_index()
                        << ", ack: " << request.ack()
-                       << ", checksum: " << request.checksum() << " }";
+                       << ", checksum: " << request.checksum()
+                       << ", session_token: " << request.session_token()
+                       << ", request_id: " << request.request_id()
+                       << ", missing_sequence_indices: [";
+
+        for (int index{0}; index < request.missing_sequence_indices_size();
+             ++index) {
+            request_stream << (index == 0 ? "" : ", ")
+                           << request.missing_sequence_indices(index);
+        }
+
+        request_stream << "] }";
+
+        return std::formatter<std::string>::format(request_stream.str(),
+                                                   context);
+    }
+};
+
+template <>
+struct std::formatter<protocol::NumberSequenceNackRequest>
+    : std::formatter<std::string> {
+    template <typename FormatContext>
+    auto format(const protocol::NumberSequenceNackRequest &request,
+                FormatContext &context) const {
+        std::ostringstream request_stream;
+        request_stream << "{" << " session_token: " << request.session_token()
+                       << ", request_id: " << request.request_id()
+                       << ", sequence_indices: [";
+
+        for (int index{0}; index < request.sequence_indices_size(); ++index) {
+            request_stream << (index == 0 ? "" : ", ")
+                           << request.sequence_indices(index);
+        }
+
+        request_stream << "], complete: " << request.complete() << " }";
 
         return std::formatter<std::string>::format(request_stream.str(),
                                                    context);
     }
 };
+
+template <>
+struct std::formatter<protocol::MulticastStreamResponse>
+    : std::formatter<std::string> {
+    template <typename FormatContext>
+    auto format(const protocol::MulticastStreamResponse &response,
+                FormatContext &context) const {
+        std::ostringstream response_stream;
+        response_stream << "{ " << "request_id: " << response.request_id()
+                        << ", stream_id: " << response.stream_id()
+                        << ", group_address: " << response.group_address()
+                        << ", port: " << response.port()
+                        << ", sequence_count: " << response.sequence_count()
+                        << " }";
+
+        return std::formatter<std::string>::format(response_stream.str(),
+                                                   context);
+    }
+};
+
+template <>
+struct std::formatter<protocol::NumberSequenceParityResponse>
+    : std::formatter<std::string> {
+    template <typename FormatContext>
+    auto format(const protocol::NumberSequenceParityResponse &response,
+                FormatContext &context) const {
+        std::ostringstream response_stream;
+        response_stream << "{ " << "request_id: " << response.request_id()
+                        << ", sequence_index: " << response.sequence_index()
+                        << ", group_sequence_count: "
+                        << response.group_sequence_count()
+                        << ", sequence_count: " << response.sequence_count()
+                        << ", number_count_parity: "
+                        << response.number_count_parity()
+                        << ", checksum_parity: " << response.checksum_parity()
+                        << ", parity_size: " << response.parity().size()
+                        << " }";
+
+        return std::formatter<std::string>::format(response_stream.str(),
+                                                   context);
+    }
+};
+
+template <>
+struct std::formatter<protocol::SharedMemoryResponse>
+    : std::formatter<std::string> {
+    template <typename FormatContext>
+    auto format(const protocol::SharedMemoryResponse &response,
+                FormatContext &context) const {
+        std::ostringstream response_stream;
+        response_stream << "{ " << "request_id: " << response.request_id()
+                        << ", path: " << response.path()
+                        << ", sequence_count: " << response.sequence_count()
+                        << ", sequence_max_number_count: "
+                        << response.sequence_max_number_count() << " }";
+
+        return std::formatter<std::string>::format(response_stream.str(),
+                                                   context);
+    }
+};
+
+template <>
+struct std::formatter<protocol::Request> : std::formatter<std::string> {
+    template <typename FormatContext>
+    auto format(const protocol::Request &request,
+                FormatContext &context) const {
+        std::string payload;
+
+        switch (request.payload_case()) {
+        case protocol::Request::kProtocolVersionRequest:
+            payload = std::format("{}", request.protocol_version_request());
+            break;
+        case protocol::Request::kNumberSequenceRequest:
+            payload = std::format("{}", request.number_sequence_request());
+            break;
+        case protocol::Request::kNumberSequenceAckRequest:
+            payload =
+                std::format("{}", request.number_sequence_ack_request());
+            break;
+        case protocol::Request::kNumberSequenceNackRequest:
+            payload =
+                std::format("{}", request.number_sequence_nack_request());
+            break;
+        default:
+            payload = "{ }";
+            break;
+        }
+
+        return std::formatter<std::string>::format(payload, context);
+    }
+};
+
+template <>
+struct std::formatter<protocol::Response> : std::formatter<std::string> {
+    template <typename FormatContext>
+    auto format(const protocol::Response &response,
+                FormatContext &context) const {
+        std::string payload;
+
+        switch (response.payload_case()) {
+        case protocol::Response::kProtocolVersionResponse:
+            payload = std::format("{}", response.protocol_version_response());
+            break;
+        case protocol::Response::kNumberSequenceResponse:
+            payload = std::format("{}", response.number_sequence_response());
+            break;
+        case protocol::Response::kMulticastStreamResponse:
+            payload = std::format("{}", response.multicast_stream_response());
+            break;
+        case protocol::Response::kNumberSequenceParityResponse:
+            payload = std::format("{}",
+                                  response.number_sequence_parity_response());
+            break;
+        case protocol::Response::kSharedMemoryResponse:
+            payload = std::format("{}", response.shared_memory_response());
+            break;
+        default:
+            payload = "{ }";
+            break;
+        }
+
+        return std::formatter<std::string>::format(payload, context);
+    }
+};
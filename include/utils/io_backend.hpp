@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string_view>
+
+namespace utils {
+
+// Asio selects its reactor at compile time. Linux builds configured with
+// UDP_ENABLE_IO_URING run every socket operation through io_uring, other
+// builds use the native reactor of the platform.
+#if defined(BOOST_ASIO_HAS_IO_URING) && defined(BOOST_ASIO_DISABLE_EPOLL)
+inline constexpr std::string_view IO_BACKEND{"io_uring"};
+#elif defined(__linux__)
+inline constexpr std::string_view IO_BACKEND{"epoll"};
+#elif defined(_WIN32)
+inline constexpr std::string_view IO_BACKEND{"iocp"};
+#else
+inline constexpr std::string_view IO_BACKEND{"kqueue"};
+#endif
+
+} // namespace utils
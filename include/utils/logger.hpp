@@ -38,7 +38,8 @@ void println(std::format_string<Args...> format, Args &&...args) {
 
 class Logger {
 public:
-    Logger();
+    // Logs to the standard output only
+    Logger() = default;
     Logger(const std::filesystem::path &logs_path) {
         if (!std::filesystem::exists(logs_path)) {
             std::filesystem::create_directories(logs_path);
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "protocol.pb.h"
+
+#include <concepts>
+
+namespace utils {
+
+// Every datagram carries a Request or Response envelope so that retransmitted
+// or reordered datagrams can be told apart from the message a peer expects.
+
+inline protocol::Request
+make_request(const protocol::ProtocolVersionRequest &payload) {
+    protocol::Request request;
+    *request.mutable_protocol_version_request() = payload;
+
+    return request;
+}
+
+inline protocol::Request
+make_request(const protocol::NumberSequenceRequest &payload) {
+    protocol::Request request;
+    *request.mutable_number_sequence_request() = payload;
+
+    return request;
+}
+
+inline protocol::Request
+make_request(const protocol::NumberSequenceAckRequest &payload) {
+    protocol::Request request;
+    *request.mutable_number_sequence_ack_request() = payload;
+
+    return request;
+}
+
+inline protocol::Request
+make_request(const protocol::NumberSequenceNackRequest &payload) {
+    protocol::Request request;
+    *request.mutable_number_sequence_nack_request() = payload;
+
+    return request;
+}
+
+inline protocol::Response
+make_response(const protocol::ProtocolVersionResponse &payload) {
+    protocol::Response response;
+    *response.mutable_protocol_version_response() = payload;
+
+    return response;
+}
+
+inline protocol::Response
+make_response(const protocol::NumberSequenceResponse &payload) {
+    protocol::Response response;
+    *response.mutable_number_sequence_response() = payload;
+
+    return response;
+}
+
+inline protocol::Response
+make_response(const protocol::MulticastStreamResponse &payload) {
+    protocol::Response response;
+    *response.mutable_multicast_stream_response() = payload;
+
+    return response;
+}
+
+inline protocol::Response
+make_response(const protocol::NumberSequenceParityResponse &payload) {
+    protocol::Response response;
+    *response.mutable_number_sequence_parity_response() = payload;
+
+    return response;
+}
+
+inline protocol::Response
+make_response(const protocol::SharedMemoryResponse &payload) {
+    protocol::Response response;
+    *response.mutable_shared_memory_response() = payload;
+
+    return response;
+}
+
+template <typename PayloadType>
+const PayloadType *get_payload(const protocol::Request &request) {
+    if constexpr (std::same_as<PayloadType, protocol::ProtocolVersionRequest>) {
+        return request.has_protocol_version_request()
+                   ? &request.protocol_version_request()
+                   : nullptr;
+    } else if constexpr (std::same_as<PayloadType,
+                                      protocol::NumberSequenceRequest>) {
+        return request.has_number_sequence_request()
+                   ? &request.number_sequence_request()
+                   : nullptr;
+    } else if constexpr (std::same_as<PayloadType,
+                                      protocol::NumberSequenceAckRequest>) {
+        return request.has_number_sequence_ack_request()
+                   ? &request.number_sequence_ack_request()
+                   : nullptr;
+    } else if constexpr (std::same_as<PayloadType,
+                                      protocol::NumberSequenceNackRequest>) {
+        return request.has_number_sequence_nack_request()
+                   ? &request.number_sequence_nack_request()
+                   : nullptr;
+    } else {
+        static_assert(!sizeof(PayloadType), "Unsupported request payload");
+    }
+}
+
+template <typename PayloadType>
+const PayloadType *get_payload(const protocol::Response &response) {
+    if constexpr (std::same_as<PayloadType,
+                               protocol::ProtocolVersionResponse>) {
+        return response.has_protocol_version_response()
+                   ? &response.protocol_version_response()
+                   : nullptr;
+    } else if constexpr (std::same_as<PayloadType,
+                                      protocol::NumberSequenceResponse>) {
+        return response.has_number_sequence_response()
+                   ? &response.number_sequence_response()
+                   : nullptr;
+    } else if constexpr (std::same_as<PayloadType,
+                                      protocol::MulticastStreamResponse>) {
+        return response.has_multicast_stream_response()
+                   ? &response.multicast_stream_response()
+                   : nullptr;
+    } else if constexpr (std::same_as<PayloadType,
+                                      protocol::NumberSequenceParityResponse>) {
+        return response.has_number_sequence_parity_response()
+                   ? &response.number_sequence_parity_response()
+                   : nullptr;
+    } else if constexpr (std::same_as<PayloadType,
+                                      protocol::SharedMemoryResponse>) {
+        return response.has_shared_memory_response()
+                   ? &response.shared_memory_response()
+                   : nullptr;
+    } else {
+        static_assert(!sizeof(PayloadType), "Unsupported response payload");
+    }
+}
+
+} // namespace utils
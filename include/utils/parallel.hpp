@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace utils {
+
+// Calls function(chunk_index) for every chunk, each on a thread of its own
+// and the first one on the calling thread, and returns once all are done.
+// Unlike std::execution::par, this runs in parallel without a backend such
+// as TBB being linked.
+template <typename Function>
+void for_each_chunk(size_t chunk_count, const Function &function) {
+    if (chunk_count == 0) {
+        return;
+    }
+
+    std::vector<std::jthread> threads;
+    threads.reserve(chunk_count - 1);
+
+    for (size_t chunk_index{1}; chunk_index < chunk_count; ++chunk_index) {
+        threads.emplace_back(
+            [&function, chunk_index] { function(chunk_index); });
+    }
+
+    function(0);
+}
+
+} // namespace utils
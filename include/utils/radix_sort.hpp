@@ -0,0 +1,233 @@
+#pragma once
+
+#include "utils/parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace utils {
+
+namespace radix {
+
+inline constexpr uint32_t DIGIT_BIT_COUNT{11};
+inline constexpr size_t DIGIT_VALUE_COUNT{size_t{1} << DIGIT_BIT_COUNT};
+inline constexpr size_t MIN_CHUNK_SIZE{1 << 16};
+
+template <typename NumberType>
+using Key = std::conditional_t<sizeof(NumberType) == 4, uint32_t, uint64_t>;
+
+// Maps a number to an unsigned key whose ascending order is the descending
+// order of the numbers. Floating-point numbers flip all bits when negative
+// and only the sign bit otherwise, signed integers flip the sign bit; the
+// result is inverted to sort in descending order.
+template <typename NumberType> Key<NumberType> to_key(NumberType number) {
+    using KeyType = Key<NumberType>;
+    constexpr KeyType sign_mask{KeyType{1} << (sizeof(KeyType) * 8 - 1)};
+
+    const auto bits = std::bit_cast<KeyType>(number);
+    KeyType key;
+
+    if constexpr (std::floating_point<NumberType>) {
+        key = (bits & sign_mask) ? static_cast<KeyType>(~bits)
+                                 : static_cast<KeyType>(bits | sign_mask);
+    } else {
+        key = static_cast<KeyType>(bits ^ sign_mask);
+    }
+
+    return static_cast<KeyType>(~key);
+}
+
+template <typename NumberType> NumberType from_key(Key<NumberType> key) {
+    using KeyType = Key<NumberType>;
+    constexpr KeyType sign_mask{KeyType{1} << (sizeof(KeyType) * 8 - 1)};
+
+    key = static_cast<KeyType>(~key);
+    KeyType bits;
+
+    if constexpr (std::floating_point<NumberType>) {
+        bits = (key & sign_mask) ? static_cast<KeyType>(key & ~sign_mask)
+                                 : static_cast<KeyType>(~key);
+    } else {
+        bits = static_cast<KeyType>(key ^ sign_mask);
+    }
+
+    return std::bit_cast<NumberType>(bits);
+}
+
+template <typename KeyType>
+inline size_t get_digit(KeyType key, uint32_t digit_index) {
+    return static_cast<size_t>(key >> (digit_index * DIGIT_BIT_COUNT)) &
+           (DIGIT_VALUE_COUNT - 1);
+}
+
+// Counts the digit values of a chunk. Four interleaved sub-histograms keep
+// consecutive increments of the same bucket independent, which lets the
+// loop run without store-to-load stalls and vectorise the digit extraction.
+template <typename KeyType>
+std::array<size_t, DIGIT_VALUE_COUNT>
+count_digits(std::span<const KeyType> keys, uint32_t digit_index) {
+    std::array<std::array<uint32_t, DIGIT_VALUE_COUNT>, 4> counts{};
+    std::array<size_t, DIGIT_VALUE_COUNT> histogram{};
+
+    // uint32_t counters are flushed before they can overflow
+    constexpr size_t block_size{size_t{1} << 30};
+
+    for (size_t block_begin{0}; block_begin < keys.size();
+         block_begin += block_size) {
+        const auto block = keys.subspan(
+            block_begin, std::min(block_size, keys.size() - block_begin));
+
+        size_t index{0};
+        for (; index + 4 <= block.size(); index += 4) {
+            ++counts[0][get_digit(block[index], digit_index)];
+            ++counts[1][get_digit(block[index + 1], digit_index)];
+            ++counts[2][get_digit(block[index + 2], digit_index)];
+            ++counts[3][get_digit(block[index + 3], digit_index)];
+        }
+
+        for (; index < block.size(); ++index) {
+            ++counts[0][get_digit(block[index], digit_index)];
+        }
+
+        for (size_t digit{0}; digit < DIGIT_VALUE_COUNT; ++digit) {
+            histogram[digit] += size_t{counts[0][digit]} + counts[1][digit] +
+                                counts[2][digit] + counts[3][digit];
+        }
+
+        counts = {};
+    }
+
+    return histogram;
+}
+
+// Moves the keys of a chunk to their output offsets. Keys are staged in
+// small per-digit buffers and written out a cache line pair at a time, which
+// keeps the scattered writes from thrashing the cache and the TLB.
+template <typename KeyType>
+void scatter_digits(std::span<const KeyType> keys,
+                    std::array<size_t, DIGIT_VALUE_COUNT> &offsets,
+                    KeyType *output, uint32_t digit_index) {
+    constexpr size_t buffer_size{128 / sizeof(KeyType)};
+
+    std::vector<std::array<KeyType, buffer_size>> buffers(DIGIT_VALUE_COUNT);
+    std::array<uint32_t, DIGIT_VALUE_COUNT> buffer_sizes{};
+
+    for (const auto key : keys) {
+        const auto digit = get_digit(key, digit_index);
+        auto &buffer_size_used = buffer_sizes[digit];
+
+        buffers[digit][buffer_size_used++] = key;
+
+        if (buffer_size_used == buffer_size) {
+            std::copy_n(buffers[digit].data(), buffer_size,
+                        output + offsets[digit]);
+            offsets[digit] += buffer_size;
+            buffer_size_used = 0;
+        }
+    }
+
+    for (size_t digit{0}; digit < DIGIT_VALUE_COUNT; ++digit) {
+        std::copy_n(buffers[digit].data(), buffer_sizes[digit],
+                    output + offsets[digit]);
+        offsets[digit] += buffer_sizes[digit];
+    }
+}
+
+} // namespace radix
+
+// Stable LSD radix sort in descending order over 11-bit digits of the keys
+// produced by radix::to_key. The input is split into one chunk per hardware
+// thread; every pass counts digits per chunk in parallel, derives each
+// chunk's output offsets from a prefix sum over (digit, chunk) and scatters
+// the chunks in parallel. Passes where all keys share the digit are skipped.
+template <typename NumberType>
+void radix_sort_descending(std::span<NumberType> numbers) {
+    using KeyType = radix::Key<NumberType>;
+    constexpr uint32_t digit_count{
+        (sizeof(KeyType) * 8 + radix::DIGIT_BIT_COUNT - 1) /
+        radix::DIGIT_BIT_COUNT};
+
+    if (numbers.size() < 2) {
+        return;
+    }
+
+    const size_t chunk_count = std::clamp<size_t>(
+        numbers.size() / radix::MIN_CHUNK_SIZE, 1,
+        std::max(std::thread::hardware_concurrency(), 1u));
+    const size_t chunk_size = (numbers.size() + chunk_count - 1) / chunk_count;
+
+    const auto get_chunk = [&](auto &values, size_t chunk_index) {
+        const auto begin = std::min(chunk_index * chunk_size, values.size());
+        const auto end = std::min(begin + chunk_size, values.size());
+
+        return std::span{values.data() + begin, end - begin};
+    };
+
+    std::vector<KeyType> keys(numbers.size());
+    std::vector<KeyType> sorted_keys(numbers.size());
+
+    for_each_chunk(chunk_count, [&](size_t chunk_index) {
+        const auto chunk = get_chunk(numbers, chunk_index);
+        const auto key_chunk = get_chunk(keys, chunk_index);
+        std::ranges::transform(chunk, key_chunk.begin(),
+                               radix::to_key<NumberType>);
+    });
+
+    std::vector<std::array<size_t, radix::DIGIT_VALUE_COUNT>> histograms(
+        chunk_count);
+
+    for (uint32_t digit_index{0}; digit_index < digit_count; ++digit_index) {
+        for_each_chunk(chunk_count, [&](size_t chunk_index) {
+            histograms[chunk_index] = radix::count_digits(
+                std::span<const KeyType>{get_chunk(keys, chunk_index)},
+                digit_index);
+        });
+
+        // Turn the counts into output offsets, digit-major and chunk-minor so
+        // that the sort stays stable
+        size_t offset{0};
+        bool single_digit_value{false};
+
+        for (size_t digit{0}; digit < radix::DIGIT_VALUE_COUNT; ++digit) {
+            size_t digit_total{0};
+
+            for (auto &histogram : histograms) {
+                const auto count = histogram[digit];
+                histogram[digit] = offset;
+                offset += count;
+                digit_total += count;
+            }
+
+            single_digit_value |= (digit_total == keys.size());
+        }
+
+        if (single_digit_value) {
+            continue;
+        }
+
+        for_each_chunk(chunk_count, [&](size_t chunk_index) {
+            radix::scatter_digits(
+                std::span<const KeyType>{get_chunk(keys, chunk_index)},
+                histograms[chunk_index], sorted_keys.data(), digit_index);
+        });
+
+        keys.swap(sorted_keys);
+    }
+
+    for_each_chunk(chunk_count, [&](size_t chunk_index) {
+        const auto key_chunk = get_chunk(keys, chunk_index);
+        const auto chunk = get_chunk(numbers, chunk_index);
+        std::ranges::transform(key_chunk, chunk.begin(),
+                               radix::from_key<NumberType>);
+    });
+}
+
+} // namespace utils
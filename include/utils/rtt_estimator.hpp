@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+
+namespace utils {
+
+// Round-trip time estimator following RFC 6298: keeps the smoothed round-trip
+// time (SRTT) and its variation (RTTVAR) and derives the retransmission
+// timeout (RTO) from them. Samples must only be taken from datagrams that were
+// not retransmitted (Karn's algorithm).
+class RttEstimator {
+public:
+    using duration = std::chrono::steady_clock::duration;
+
+    RttEstimator(duration initial_timeout, duration min_timeout,
+                 duration max_timeout)
+        : timeout_{initial_timeout}, min_timeout_{min_timeout},
+          max_timeout_{max_timeout} {}
+
+    void add_sample(duration round_trip_time) {
+        if (!smoothed_rtt_) {
+            smoothed_rtt_ = round_trip_time;
+            rtt_variation_ = round_trip_time / 2;
+        } else {
+            const auto deviation = (*smoothed_rtt_ > round_trip_time)
+                                       ? (*smoothed_rtt_ - round_trip_time)
+                                       : (round_trip_time - *smoothed_rtt_);
+            rtt_variation_ = (rtt_variation_ * 3 + deviation) / 4;
+            smoothed_rtt_ = (*smoothed_rtt_ * 7 + round_trip_time) / 8;
+        }
+
+        timeout_ = std::clamp(*smoothed_rtt_ + std::max(CLOCK_GRANULARITY,
+                                                        rtt_variation_ * 4),
+                              min_timeout_, max_timeout_);
+    }
+
+    void backoff() { timeout_ = std::min(timeout_ * 2, max_timeout_); }
+
+    inline duration timeout() const { return timeout_; }
+    inline std::optional<duration> smoothed_rtt() const {
+        return smoothed_rtt_;
+    }
+    inline duration rtt_variation() const { return rtt_variation_; }
+
+private:
+    static constexpr duration CLOCK_GRANULARITY{std::chrono::microseconds{1}};
+
+    duration timeout_;
+    duration min_timeout_;
+    duration max_timeout_;
+    std::optional<duration> smoothed_rtt_;
+    duration rtt_variation_{};
+};
+
+} // namespace utils
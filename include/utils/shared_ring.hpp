@@ -0,0 +1,387 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <ctime>
+#endif
+
+namespace utils {
+
+#if defined(__linux__)
+inline constexpr bool SHARED_MEMORY_SUPPORTED{true};
+#else
+inline constexpr bool SHARED_MEMORY_SUPPORTED{false};
+#endif
+
+// Single-producer single-consumer ring of number sequences in a memfd
+// shared by the server and a client on the same host. The server creates
+// the ring, the client opens it through the descriptor of the server under
+// /proc and reads every sequence in place. Each side counts the sequences it
+// has written or read in the ring header and waits for the count of the
+// other side with a futex, so a sequence is never copied through the kernel
+// and only costs a wake-up call. Either side may write to the header, so the
+// layout of the ring is read from it once and kept in the object.
+class SharedRing {
+public:
+    // A sequence read in place, valid until popped
+    template <typename NumberType> struct Sequence {
+        uint64_t sequence_index;
+        uint64_t checksum;
+        std::span<const NumberType> numbers;
+    };
+
+    SharedRing() = default;
+
+    // Slots hold sequence_size bytes of numbers each, a multiple of
+    // SLOT_ALIGNMENT
+    static SharedRing create(uint32_t slot_count, uint64_t sequence_size) {
+        SharedRing ring;
+        ring.owner_ = true;
+        ring.slot_count_ = slot_count;
+        ring.slot_size_ = SLOT_HEADER_SIZE + sequence_size;
+        ring.size_ = HEADER_SIZE + ring.slot_count_ * ring.slot_size_;
+
+#if defined(__linux__)
+        ring.file_ = memfd_create("udp-number-ring", MFD_CLOEXEC);
+        if (ring.file_ == -1) {
+            throw std::runtime_error{"Failed to create shared memory ring"};
+        }
+
+        if (ftruncate(ring.file_, static_cast<off_t>(ring.size_)) == -1) {
+            throw std::runtime_error{std::format(
+                "Failed to size shared memory ring to {} bytes", ring.size_)};
+        }
+
+        ring.map();
+
+        auto &header = *new (ring.data_) Header{};
+        header.magic = MAGIC;
+        header.slot_count = ring.slot_count_;
+        header.slot_size = ring.slot_size_;
+#else
+        static_cast<void>(sequence_size);
+        throw std::runtime_error{
+            "Shared memory rings are only supported on Linux"};
+#endif
+
+        return ring;
+    }
+
+    // Opens the ring created by another process from its path
+    static SharedRing open(const std::string &path) {
+        SharedRing ring;
+
+#if defined(__linux__)
+        ring.file_ = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+        if (ring.file_ == -1) {
+            throw std::runtime_error{std::format(
+                "Failed to open shared memory ring. Path: {}", path)};
+        }
+
+        struct stat file_status {};
+        if (fstat(ring.file_, &file_status) == -1 ||
+            static_cast<size_t>(file_status.st_size) < HEADER_SIZE) {
+            throw std::runtime_error{std::format(
+                "Shared memory ring is truncated. Path: {}", path)};
+        }
+
+        ring.size_ = static_cast<size_t>(file_status.st_size);
+        ring.map();
+
+        // The mapping stays valid once the descriptor is closed
+        ::close(std::exchange(ring.file_, -1));
+
+        const auto &header = ring.header();
+        ring.slot_count_ = header.slot_count;
+        ring.slot_size_ = header.slot_size;
+
+        // Checked without overflow, the header may hold any values
+        if (header.magic != MAGIC || ring.slot_count_ == 0 ||
+            ring.slot_size_ < SLOT_HEADER_SIZE ||
+            ring.slot_size_ % SLOT_ALIGNMENT != 0 ||
+            ring.slot_size_ > (ring.size_ - HEADER_SIZE) / ring.slot_count_) {
+            throw std::runtime_error{std::format(
+                "Invalid shared memory ring. Path: {}", path)};
+        }
+
+        ring.read_count_ = header.read_count.load(std::memory_order_relaxed);
+#else
+        throw std::runtime_error{std::format(
+            "Shared memory rings are only supported on Linux. Path: {}",
+            path)};
+#endif
+
+        return ring;
+    }
+
+    SharedRing(const SharedRing &) = delete;
+    SharedRing &operator=(const SharedRing &) = delete;
+
+    SharedRing(SharedRing &&other) noexcept
+        : data_{std::exchange(other.data_, nullptr)},
+          size_{std::exchange(other.size_, 0)},
+          file_{std::exchange(other.file_, -1)},
+          owner_{std::exchange(other.owner_, false)},
+          slot_count_{other.slot_count_}, slot_size_{other.slot_size_},
+          write_count_{other.write_count_}, read_count_{other.read_count_} {}
+
+    SharedRing &operator=(SharedRing &&other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            file_ = std::exchange(other.file_, -1);
+            owner_ = std::exchange(other.owner_, false);
+            slot_count_ = other.slot_count_;
+            slot_size_ = other.slot_size_;
+            write_count_ = other.write_count_;
+            read_count_ = other.read_count_;
+        }
+
+        return *this;
+    }
+
+    ~SharedRing() { release(); }
+
+    // Opened by the client while the server keeps the ring open
+    std::string path() const {
+#if defined(__linux__)
+        return std::format("/proc/{}/fd/{}", getpid(), file_);
+#else
+        return {};
+#endif
+    }
+
+    template <typename NumberType> uint64_t sequence_capacity() const {
+        return (slot_size_ - SLOT_HEADER_SIZE) / sizeof(NumberType);
+    }
+
+    // Waits until a slot is free, false if the timeout expires or the
+    // reader closes the ring first
+    bool wait_writable(std::chrono::nanoseconds timeout) {
+        auto &header = this->header();
+
+        return wait(header.read_count, timeout, [&](uint32_t read_count) {
+            return write_count_ - read_count < slot_count_ || is_closed();
+        }) && !is_closed();
+    }
+
+    template <typename NumberType>
+    void write(uint64_t sequence_index, std::span<const NumberType> numbers,
+               uint64_t checksum) {
+        auto &header = this->header();
+        if (numbers.size() > sequence_capacity<NumberType>()) {
+            throw std::runtime_error{std::format(
+                "Number sequence {} exceeds the shared memory slot",
+                sequence_index)};
+        }
+
+        auto *slot = get_slot(write_count_);
+        const SlotHeader slot_header{sequence_index, numbers.size(),
+                                     checksum};
+        std::memcpy(slot, &slot_header, sizeof(slot_header));
+        std::memcpy(slot + SLOT_HEADER_SIZE, numbers.data(),
+                    numbers.size_bytes());
+
+        header.write_count.store(++write_count_, std::memory_order_release);
+        wake(header.write_count);
+    }
+
+    // Waits until a sequence is written, false if the timeout expires or the
+    // writer closes the ring first
+    bool wait_readable(std::chrono::nanoseconds timeout) {
+        auto &header = this->header();
+
+        return wait(header.write_count, timeout, [&](uint32_t write_count) {
+            return write_count != read_count_ || is_closed();
+        }) && is_readable();
+    }
+
+    bool is_readable() const {
+        return header().write_count.load(std::memory_order_acquire) !=
+               read_count_;
+    }
+
+    // The oldest sequence not yet popped, the ring has to be readable
+    template <typename NumberType> Sequence<NumberType> read() const {
+        const auto *slot = get_slot(read_count_);
+        SlotHeader slot_header;
+        std::memcpy(&slot_header, slot, sizeof(slot_header));
+
+        if (slot_header.number_count > sequence_capacity<NumberType>()) {
+            throw std::runtime_error{std::format(
+                "Number sequence {} exceeds the shared memory slot",
+                slot_header.sequence_index)};
+        }
+
+        return {slot_header.sequence_index, slot_header.checksum,
+                {reinterpret_cast<const NumberType *>(slot + SLOT_HEADER_SIZE),
+                 static_cast<size_t>(slot_header.number_count)}};
+    }
+
+    // Either side closes the ring once it stops, which wakes the other one.
+    // The writer closes it when it goes away.
+    void close() {
+        auto &header = this->header();
+        header.closed.store(1, std::memory_order_release);
+        wake(header.write_count);
+        wake(header.read_count);
+    }
+
+    bool is_closed() const {
+        return header().closed.load(std::memory_order_acquire) != 0;
+    }
+
+    // Hands the slot of the oldest sequence back to the writer
+    void pop() {
+        auto &header = this->header();
+        header.read_count.store(++read_count_, std::memory_order_release);
+        wake(header.read_count);
+    }
+
+private:
+    static constexpr uint64_t MAGIC{0x676e69722d706475}; // "udp-ring"
+    static constexpr size_t SLOT_ALIGNMENT{64};
+    static constexpr size_t HEADER_SIZE{256};
+    static constexpr size_t SLOT_HEADER_SIZE{SLOT_ALIGNMENT};
+
+    // The counts only grow and wrap around, the futexes wait on them
+    struct Header {
+        uint64_t magic;
+        uint64_t slot_count;
+        uint64_t slot_size;
+        // Set by either side once it stops
+        std::atomic<uint32_t> closed;
+        alignas(64) std::atomic<uint32_t> write_count;
+        alignas(64) std::atomic<uint32_t> read_count;
+    };
+
+    struct SlotHeader {
+        uint64_t sequence_index;
+        uint64_t number_count;
+        uint64_t checksum;
+    };
+
+    static_assert(sizeof(Header) <= HEADER_SIZE);
+    static_assert(sizeof(SlotHeader) <= SLOT_HEADER_SIZE);
+    static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+                  sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+
+    Header &header() const { return *reinterpret_cast<Header *>(data_); }
+
+    std::byte *get_slot(uint32_t count) const {
+        return data_ + HEADER_SIZE + (count % slot_count_) * slot_size_;
+    }
+
+    void map() {
+#if defined(__linux__)
+        auto *mapping = mmap(nullptr, size_, PROT_READ | PROT_WRITE,
+                             MAP_SHARED, file_, 0);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error{std::format(
+                "Failed to map shared memory ring of {} bytes", size_)};
+        }
+
+        data_ = static_cast<std::byte *>(mapping);
+#endif
+    }
+
+    // Sleeps on the futex while the count keeps its value, the wait is
+    // repeated after spurious wake-ups until the deadline
+    template <typename Predicate>
+    static bool wait(std::atomic<uint32_t> &count,
+                     std::chrono::nanoseconds timeout, Predicate &&ready) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        for (;;) {
+            const auto value = count.load(std::memory_order_acquire);
+            if (ready(value)) {
+                return true;
+            }
+
+            const auto remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::nanoseconds::zero()) {
+                return false;
+            }
+
+#if defined(__linux__)
+            const auto seconds =
+                std::chrono::duration_cast<std::chrono::seconds>(remaining);
+            const timespec wait_time{
+                static_cast<time_t>(seconds.count()),
+                static_cast<long>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        remaining - seconds)
+                        .count())};
+
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&count),
+                    FUTEX_WAIT, value, &wait_time, nullptr, 0);
+#else
+            return false;
+#endif
+        }
+    }
+
+    static void wake(std::atomic<uint32_t> &count) {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&count), FUTEX_WAKE,
+                INT_MAX, nullptr, nullptr, 0);
+#else
+        static_cast<void>(count);
+#endif
+    }
+
+    void release() {
+        if (data_ && owner_) {
+            close();
+        }
+
+#if defined(__linux__)
+        if (data_) {
+            munmap(data_, size_);
+        }
+
+        if (file_ != -1) {
+            ::close(file_);
+        }
+#endif
+
+        data_ = nullptr;
+        size_ = 0;
+        file_ = -1;
+        owner_ = false;
+    }
+
+    std::byte *data_{nullptr};
+    size_t size_{0};
+    int file_{-1};
+    // The writer closes the ring when it goes away
+    bool owner_{false};
+    // The layout, never read from the header again once created or opened
+    uint64_t slot_count_{0};
+    uint64_t slot_size_{0};
+    // Local copies of the counts of this side
+    uint32_t write_count_{0};
+    uint32_t read_count_{0};
+};
+
+} // namespace utils
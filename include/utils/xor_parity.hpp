@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace utils {
+
+// XOR parity of a group of number sequences, their numbers as raw bytes
+// padded with zeros to the longest sequence. Adding the parity of a group
+// and all of its sequences but one leaves the missing sequence: its bytes,
+// its number count and its checksum.
+class XorParity {
+public:
+    void add(std::span<const std::byte> bytes, uint64_t number_count,
+             uint64_t checksum) {
+        if (bytes_.size() < bytes.size()) {
+            bytes_.resize(bytes.size(), '\0');
+        }
+
+        for (size_t index{0}; index < bytes.size(); ++index) {
+            bytes_[index] ^= static_cast<char>(bytes[index]);
+        }
+
+        number_count_ ^= number_count;
+        checksum_ ^= checksum;
+    }
+
+    template <typename NumberType>
+    void add(std::span<const NumberType> numbers, uint64_t checksum) {
+        add(std::as_bytes(numbers), numbers.size(), checksum);
+    }
+
+    void clear() {
+        bytes_.clear();
+        number_count_ = 0;
+        checksum_ = 0;
+    }
+
+    inline const std::string &bytes() const { return bytes_; }
+    inline uint64_t number_count() const { return number_count_; }
+    inline uint64_t checksum() const { return checksum_; }
+
+private:
+    std::string bytes_;
+    uint64_t number_count_{0};
+    uint64_t checksum_{0};
+};
+
+} // namespace utils
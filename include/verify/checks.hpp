@@ -0,0 +1,182 @@
+#pragma once
+
+#include "utils/checksum.hpp"
+#include "utils/parallel.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace verify {
+
+namespace checks {
+
+inline constexpr size_t MIN_CHUNK_SIZE{1 << 20};
+// Numbers checked per block, small enough for a block to stay in the L1 cache
+// between the kernels
+inline constexpr size_t BLOCK_SIZE{2048};
+
+} // namespace checks
+
+struct CheckResult {
+    // Pairs of neighbours not in strictly descending order
+    uint64_t order_violation_count{0};
+    std::optional<size_t> first_order_violation;
+    // Numbers outside of the bounds, NaN included
+    uint64_t bound_violation_count{0};
+    std::optional<size_t> first_bound_violation;
+    uint64_t checksum{0};
+};
+
+namespace checks {
+
+// The kernels are branch-free and accumulate into integers, so the compiler
+// vectorises them for the target instruction set. Comparisons are negated to
+// count NaN as a violation.
+template <typename NumberType>
+uint64_t count_order_violations(const NumberType *numbers, size_t pair_count) {
+    uint64_t violation_count{0};
+
+    for (size_t index{0}; index < pair_count; ++index) {
+        violation_count += !(numbers[index] > numbers[index + 1]);
+    }
+
+    return violation_count;
+}
+
+template <typename NumberType>
+uint64_t count_bound_violations(const NumberType *numbers, size_t count,
+                                NumberType lower_bound,
+                                NumberType upper_bound) {
+    uint64_t violation_count{0};
+
+    for (size_t index{0}; index < count; ++index) {
+        violation_count += !((numbers[index] >= lower_bound) &
+                             (numbers[index] <= upper_bound));
+    }
+
+    return violation_count;
+}
+
+template <typename NumberType>
+uint64_t sum_bit_patterns(const NumberType *numbers, size_t count) {
+    uint64_t checksum{0};
+
+    for (size_t index{0}; index < count; ++index) {
+        checksum += utils::get_bit_pattern(numbers[index]);
+    }
+
+    return checksum;
+}
+
+// Checks the numbers in [begin, end) and their pairs with the following
+// number, which may lie in the next chunk. Violations are located by a
+// scalar pass over the first block containing any.
+template <typename NumberType>
+CheckResult check_chunk(std::span<const NumberType> numbers, size_t begin,
+                        size_t end, NumberType lower_bound,
+                        NumberType upper_bound) {
+    CheckResult result;
+
+    for (size_t block_begin{begin}; block_begin < end;
+         block_begin += BLOCK_SIZE) {
+        const auto block_end = std::min(block_begin + BLOCK_SIZE, end);
+        const auto *block = numbers.data() + block_begin;
+        const auto count = block_end - block_begin;
+        const auto pair_count =
+            std::min(block_end, numbers.size() - 1) - block_begin;
+
+        const auto order_violation_count =
+            count_order_violations(block, pair_count);
+        const auto bound_violation_count =
+            count_bound_violations(block, count, lower_bound, upper_bound);
+        result.checksum += sum_bit_patterns(block, count);
+
+        if (order_violation_count != 0 && !result.first_order_violation) {
+            for (size_t index{0}; index < pair_count; ++index) {
+                if (!(block[index] > block[index + 1])) {
+                    result.first_order_violation = block_begin + index;
+                    break;
+                }
+            }
+        }
+
+        if (bound_violation_count != 0 && !result.first_bound_violation) {
+            for (size_t index{0}; index < count; ++index) {
+                if (!(block[index] >= lower_bound &&
+                      block[index] <= upper_bound)) {
+                    result.first_bound_violation = block_begin + index;
+                    break;
+                }
+            }
+        }
+
+        result.order_violation_count += order_violation_count;
+        result.bound_violation_count += bound_violation_count;
+    }
+
+    return result;
+}
+
+inline std::optional<size_t> get_first(std::optional<size_t> first,
+                                       std::optional<size_t> second) {
+    if (!first || !second) {
+        return first ? first : second;
+    }
+
+    return std::min(*first, *second);
+}
+
+} // namespace checks
+
+// Checks that the numbers are strictly descending, hence distinct, and lie
+// within [lower_bound, upper_bound], and sums their bit patterns as the
+// protocol checksum does. The numbers are split into one chunk per hardware
+// thread, which are checked in parallel.
+template <typename NumberType>
+CheckResult check_numbers(
+    std::span<const NumberType> numbers,
+    NumberType lower_bound = std::numeric_limits<NumberType>::lowest(),
+    NumberType upper_bound = std::numeric_limits<NumberType>::max()) {
+    if (numbers.empty()) {
+        return {};
+    }
+
+    const size_t chunk_count = std::clamp<size_t>(
+        numbers.size() / checks::MIN_CHUNK_SIZE, 1,
+        std::max(std::thread::hardware_concurrency(), 1u));
+    const size_t chunk_size = (numbers.size() + chunk_count - 1) / chunk_count;
+
+    std::vector<CheckResult> chunk_results(chunk_count);
+
+    utils::for_each_chunk(chunk_count, [&](size_t chunk_index) {
+        const auto begin = std::min(chunk_index * chunk_size, numbers.size());
+        const auto end = std::min(begin + chunk_size, numbers.size());
+
+        chunk_results[chunk_index] = checks::check_chunk(
+            numbers, begin, end, lower_bound, upper_bound);
+    });
+
+    CheckResult result;
+
+    for (const auto &chunk_result : chunk_results) {
+        result.order_violation_count += chunk_result.order_violation_count;
+        result.first_order_violation =
+            checks::get_first(result.first_order_violation,
+                              chunk_result.first_order_violation);
+        result.bound_violation_count += chunk_result.bound_violation_count;
+        result.first_bound_violation =
+            checks::get_first(result.first_bound_violation,
+                              chunk_result.first_bound_violation);
+        result.checksum += chunk_result.checksum;
+    }
+
+    return result;
+}
+
+} // namespace verify
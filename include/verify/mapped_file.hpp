@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace verify {
+
+// Read-only view of a whole file, mapped into memory so that multi-gigabyte
+// outputs are checked without copying them
+class MappedFile {
+public:
+    MappedFile(const std::filesystem::path &path);
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile();
+
+    inline std::span<const std::byte> bytes() const { return {data_, size_}; }
+
+private:
+    const std::byte *data_{nullptr};
+    size_t size_{0};
+#if defined(_WIN32)
+    void *file_{nullptr};
+    void *mapping_{nullptr};
+#endif
+};
+
+} // namespace verify
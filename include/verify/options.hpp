@@ -0,0 +1,34 @@
+#pragma once
+
+#include <boost/program_options.hpp>
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace verify {
+
+// The verifier runs without config and logs, so it does not share the
+// options of the client and the server
+class CommandLineOptions {
+public:
+    CommandLineOptions();
+
+    void parse(int argc, char *argv[]);
+
+    inline const std::filesystem::path &numbers_path() const {
+        return numbers_path_;
+    }
+    inline const std::string &element_type() const { return element_type_; }
+    inline std::optional<double> upper_bound() const { return upper_bound_; }
+    inline std::optional<double> lower_bound() const { return lower_bound_; }
+
+private:
+    boost::program_options::options_description description_;
+    std::filesystem::path numbers_path_;
+    std::string element_type_;
+    std::optional<double> upper_bound_;
+    std::optional<double> lower_bound_;
+};
+
+} // namespace verify
@@ -0,0 +1,10 @@
+param(
+    [string]$BuildType = "Debug"
+)
+
+$projectDirectory = Get-Location | Select-Object -ExpandProperty Path
+$executablePath = "$projectDirectory\build\$BuildType\udp_verify.exe"
+$numbersPath = "$projectDirectory\build\$BuildType\numbers.bin"
+
+# Further arguments are passed on, e.g. --element-type and --upper-bound
+& $executablePath --numbers-path $numbersPath @args
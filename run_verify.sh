@@ -0,0 +1,15 @@
+#!/bin/bash
+
+BuildType="Debug"
+
+if [ "$1" != "" ]; then
+    BuildType="$1"
+fi
+
+projectDirectory=$(pwd)
+
+executablePath="$projectDirectory/build/$BuildType/udp_verify"
+numbersPath="$projectDirectory/build/$BuildType/numbers.bin"
+
+# Further arguments are passed on, e.g. --element-type and --upper-bound
+"$executablePath" --numbers-path "$numbersPath" "${@:2}"
@@ -0,0 +1,20 @@
+#include "client/client.hpp"
+#include "client/striped_client.hpp"
+
+namespace client {
+
+template class UDPNumberSorterClient<
+    utils::ElementTraits<protocol::ELEMENT_FLOAT64>>;
+template class UDPNumberSorterClient<
+    utils::ElementTraits<protocol::ELEMENT_FLOAT32>>;
+template class UDPNumberSorterClient<
+    utils::ElementTraits<protocol::ELEMENT_INT32>>;
+template class UDPNumberSorterClient<
+    utils::ElementTraits<protocol::ELEMENT_INT64>>;
+
+template class StripedClient<utils::ElementTraits<protocol::ELEMENT_FLOAT64>>;
+template class StripedClient<utils::ElementTraits<protocol::ELEMENT_FLOAT32>>;
+template class StripedClient<utils::ElementTraits<protocol::ELEMENT_INT32>>;
+template class StripedClient<utils::ElementTraits<protocol::ELEMENT_INT64>>;
+
+} // namespace client
@@ -1,4 +1,5 @@
 #include "client/config.hpp"
+#include "utils/element_type.hpp"
 
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
@@ -7,6 +8,19 @@
 
 using namespace client;
 
+namespace {
+
+std::optional<double>
+get_lower_bound(const boost::property_tree::ptree &request) {
+    if (const auto lower_bound = request.get_optional<double>("lower_bound")) {
+        return *lower_bound;
+    }
+
+    return std::nullopt;
+}
+
+} // namespace
+
 Config::Config() : Config(std::filesystem::path{"config.json"}) {}
 
 Config::Config(const std::filesystem::path &path) {
@@ -18,8 +32,107 @@ Config::Config(const std::filesystem::path &path) {
     boost::property_tree::ptree root;
     boost::property_tree::read_json(path.string(), root);
 
-    port_ = root.get<uint32_t>("port");
-    host_ = root.get<std::string>("host");
-    number_count_ = root.get<uint64_t>("number_count");
-    upper_bound_ = root.get<double>("upper_bound");
+    // A job is divided across several servers if given, a single server
+    // may be given by the top-level keys
+    if (const auto servers = root.get_child_optional("servers")) {
+        for (const auto &[key, value] : *servers) {
+            settings_.servers.push_back(
+                {value.get<std::string>("host"),
+                 static_cast<uint16_t>(value.get<uint32_t>("port")),
+                 value.get<double>("weight", 1.0)});
+        }
+    } else {
+        settings_.servers.push_back(
+            {root.get<std::string>("host"),
+             static_cast<uint16_t>(root.get<uint32_t>("port"))});
+    }
+
+    // Several requests are pipelined on one session, a single request may
+    // be given by the top-level keys
+    if (const auto requests = root.get_child_optional("requests")) {
+        for (const auto &[key, value] : *requests) {
+            settings_.requests.push_back(
+                {value.get<uint64_t>("number_count"),
+                 value.get<double>("upper_bound"),
+                 get_lower_bound(value)});
+        }
+    } else {
+        settings_.requests.push_back({root.get<uint64_t>("number_count"),
+                                      root.get<double>("upper_bound"),
+                                      get_lower_bound(root)});
+    }
+
+    settings_.server_side_sort = root.get<bool>("server_side_sort", false);
+    settings_.element_type = utils::parse_element_type(
+        root.get<std::string>("element_type", "float64"));
+
+    const auto distribution =
+        root.get<std::string>("distribution", "uniform");
+    if (distribution == "uniform") {
+        settings_.distribution = protocol::DISTRIBUTION_UNIFORM;
+    } else if (distribution == "normal") {
+        settings_.distribution = protocol::DISTRIBUTION_NORMAL;
+    } else if (distribution == "exponential") {
+        settings_.distribution = protocol::DISTRIBUTION_EXPONENTIAL;
+    } else {
+        throw std::runtime_error(
+            std::format("Unsupported distribution: {}", distribution));
+    }
+
+    const auto sort_algorithm =
+        root.get<std::string>("sort_algorithm", "comparison");
+    if (sort_algorithm == "comparison") {
+        settings_.sort_algorithm = SortAlgorithm::COMPARISON;
+    } else if (sort_algorithm == "radix") {
+        settings_.sort_algorithm = SortAlgorithm::RADIX;
+    } else {
+        throw std::runtime_error(
+            std::format("Unsupported sort algorithm: {}", sort_algorithm));
+    }
+
+    settings_.landing_buffer = root.get<bool>("landing_buffer", false);
+    settings_.huge_pages = root.get<bool>("huge_pages", false);
+    settings_.multicast = root.get<bool>("multicast", false);
+    settings_.multicast_interface =
+        root.get<std::string>("multicast_interface", "");
+    settings_.fec_group_size = root.get<uint32_t>("fec_group_size", 0);
+    settings_.shared_memory = root.get<bool>("shared_memory", false);
+
+    validate();
+}
+
+Config::Config(Settings settings) : settings_{std::move(settings)} {
+    validate();
+}
+
+void Config::validate() const {
+    if (settings_.requests.empty()) {
+        throw std::runtime_error("At least one number request is required");
+    }
+
+    if (settings_.servers.empty()) {
+        throw std::runtime_error("At least one server is required");
+    }
+
+    if (settings_.distribution != protocol::DISTRIBUTION_UNIFORM) {
+        if (settings_.server_side_sort) {
+            throw std::runtime_error("Server-side sort is only supported for "
+                                     "the uniform distribution");
+        }
+
+        // Servers are given shares of the range in proportion to their
+        // shares of the numbers, which only holds for uniform numbers
+        if (settings_.servers.size() > 1) {
+            throw std::runtime_error("Several servers are only supported for "
+                                     "the uniform distribution");
+        }
+    }
+
+    for (const auto &server : settings_.servers) {
+        if (!(server.weight > 0)) {
+            throw std::runtime_error(std::format(
+                "Server weight must be greater than zero: {}:{}", server.host,
+                server.port));
+        }
+    }
 }
@@ -1,12 +1,38 @@
 #include "server/config.hpp"
+#include "constants.hpp"
 
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
 
+#include <algorithm>
 #include <format>
 
 using namespace server;
 
+namespace {
+
+std::vector<uint32_t> read_cpu_list(const boost::property_tree::ptree &root,
+                                    const std::string &path) {
+    std::vector<uint32_t> cpus;
+
+    if (const auto cpu_list = root.get_child_optional(path)) {
+        for (const auto &[key, value] : *cpu_list) {
+            const auto cpu = value.get_value<uint32_t>();
+            if (cpu >= MAX_CPU_COUNT) {
+                throw std::runtime_error(
+                    std::format("CPU {} in {} must be less than {}", cpu,
+                                path, MAX_CPU_COUNT));
+            }
+
+            cpus.push_back(cpu);
+        }
+    }
+
+    return cpus;
+}
+
+} // namespace
+
 Config::Config() : Config(std::filesystem::path{"config.json"}) {}
 
 Config::Config(const std::filesystem::path &path) {
@@ -19,4 +45,78 @@ Config::Config(const std::filesystem::path &path) {
     boost::property_tree::read_json(path.string(), root);
 
     port_ = root.get<uint32_t>("port");
+
+    // Thread topology is optional, missing entries are derived from the
+    // network interface and the machine layout
+    if (const auto io_thread_count =
+            root.get_optional<uint32_t>("threads.io_thread_count")) {
+        io_thread_count_ = *io_thread_count;
+    }
+
+    if (const auto generator_thread_count =
+            root.get_optional<uint32_t>("threads.generator_thread_count")) {
+        generator_thread_count_ = *generator_thread_count;
+    }
+
+    io_cpus_ = read_cpu_list(root, "threads.io_cpus");
+    generator_cpus_ = read_cpu_list(root, "threads.generator_cpus");
+
+    if (const auto numa_node =
+            root.get_optional<uint32_t>("threads.numa_node")) {
+        numa_node_ = *numa_node;
+    }
+
+    network_interface_ = root.get<std::string>("threads.network_interface", "");
+
+    // Multicast streams are only offered when a group is configured
+    multicast_group_ = root.get<std::string>("multicast.group", "");
+    multicast_port_ = root.get<uint16_t>("multicast.port", 0);
+    multicast_interface_ = root.get<std::string>("multicast.interface", "");
+    multicast_rate_ = root.get<uint32_t>("multicast.rate", 10000);
+    multicast_ttl_ =
+        static_cast<uint8_t>(root.get<uint32_t>("multicast.ttl", 1));
+
+    if (!multicast_group_.empty() &&
+        (multicast_port_ == 0 || multicast_rate_ == 0)) {
+        throw std::runtime_error(
+            "Multicast port and rate must be greater than zero");
+    }
+
+    // Requests over the session and number limits wait in a bounded queue,
+    // requests over the client rate are rejected
+    max_session_count_ = root.get<uint32_t>("admission.max_session_count", 0);
+    max_numbers_in_flight_ =
+        root.get<uint64_t>("admission.max_numbers_in_flight", 0);
+    client_rate_ = root.get<double>("admission.client_rate", 0.0);
+    client_burst_ =
+        root.get<double>("admission.client_burst", std::max(client_rate_, 1.0));
+    admission_queue_size_ = root.get<uint32_t>("admission.queue_size", 64);
+    admission_queue_timeout_ = std::chrono::milliseconds{
+        root.get<uint32_t>("admission.queue_timeout_ms", 100)};
+    retry_after_ = std::chrono::milliseconds{
+        root.get<uint32_t>("admission.retry_after_ms", 1000)};
+
+    if (client_rate_ < 0.0 || client_burst_ < 1.0) {
+        throw std::runtime_error("Client rate must not be negative and client "
+                                 "burst must be at least one");
+    }
+
+    fec_max_group_size_ = root.get<uint32_t>("fec.max_group_size", 16);
+
+    if (fec_max_group_size_ > FEC_MAX_GROUP_SIZE) {
+        throw std::runtime_error(std::format(
+            "FEC group size must not exceed {}", FEC_MAX_GROUP_SIZE));
+    }
+
+    shared_memory_slot_count_ =
+        root.get<uint32_t>("shared_memory.slot_count", 8);
+    shared_memory_sequence_size_ =
+        root.get<uint64_t>("shared_memory.sequence_size", uint64_t{1} << 20);
+
+    // Keeps the numbers of every slot aligned
+    if (shared_memory_sequence_size_ == 0 ||
+        (shared_memory_sequence_size_ % 64) != 0) {
+        throw std::runtime_error("Shared memory sequence size must be a "
+                                 "positive multiple of 64 bytes");
+    }
 }
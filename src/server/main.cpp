@@ -1,25 +1,59 @@
 #include "constants.hpp"
 #include "protocol.pb.h"
 #include "server/config.hpp"
+#include "server/cookie.hpp"
+#include "server/descending_generator.hpp"
+#include "server/philox.hpp"
+#include "server/range_shuffle.hpp"
+#include "server/samplers.hpp"
+#include "server/token_bucket.hpp"
+#include "server/topology.hpp"
 #include "utils/checksum.hpp"
+#include "utils/element_type.hpp"
 #include "utils/formatters.hpp"
+#include "utils/io_backend.hpp"
 #include "utils/logger.hpp"
+#include "utils/messages.hpp"
 #include "utils/options.hpp"
+#include "utils/rtt_estimator.hpp"
+#include "utils/shared_ring.hpp"
+#include "utils/xor_parity.hpp"
 
 #include <boost/asio/as_tuple.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/co_spawn.hpp>
 #include <boost/asio/detached.hpp>
+#include <boost/asio/experimental/awaitable_operators.hpp>
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/multicast.hpp>
 #include <boost/asio/ip/udp.hpp>
 #include <boost/asio/signal_set.hpp>
-
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <concepts>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
 #include <random>
+#include <ranges>
+#include <set>
+#include <span>
 #include <thread>
+#include <tuple>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
 
 using boost::asio::as_tuple_t;
 using boost::asio::awaitable;
@@ -29,19 +63,34 @@ using boost::asio::use_awaitable_t;
 using boost::asio::ip::udp;
 using default_token = as_tuple_t<use_awaitable_t<>>;
 using udp_socket = default_token::as_default_on_t<udp::socket>;
+using steady_timer = default_token::as_default_on_t<boost::asio::steady_timer>;
 
 namespace this_coro = boost::asio::this_coro;
+using namespace boost::asio::experimental::awaitable_operators;
 using namespace protocol;
 
 class UDPRandomGeneratorServer {
 public:
     UDPRandomGeneratorServer(boost::asio::io_context &io_context,
+                             boost::asio::io_context &generator_context,
                              const server::Config &config,
                              utils::Logger &logger)
-        : io_context_{io_context},
+        : generator_context_{generator_context},
+          strand_{boost::asio::make_strand(io_context)},
           socket_{io_context, udp::endpoint{udp::v4(), config.port()}},
-          buffer_(MESSAGE_MAX_SIZE, '\0'), logger_{logger} {
+          buffer_(MESSAGE_MAX_SIZE, '\0'), config_{config}, logger_{logger},
+          cookie_generator_{SESSION_COOKIE_LIFETIME},
+          seed_generator_{std::random_device{}()}, admission_timer_{strand_} {
         socket_.set_option(boost::asio::socket_base::reuse_address(true));
+
+        if (!config.multicast_group().empty()) {
+            enable_multicast(config);
+        }
+
+        if (utils::SHARED_MEMORY_SUPPORTED &&
+            config.shared_memory_slot_count() != 0) {
+            shared_memory_waiter_.emplace(SHARED_MEMORY_WAITER_THREAD_COUNT);
+        }
     }
 
     UDPRandomGeneratorServer(const UDPRandomGeneratorServer &) = delete;
@@ -52,78 +101,1366 @@ public:
 
     void start() {
         co_spawn(
-            io_context_,
+            strand_,
             [this]() -> boost::asio::awaitable<void> { co_await run(); },
             detached);
+        co_spawn(strand_, expire_sessions(), detached);
+        co_spawn(strand_, expire_queued_requests(), detached);
     }
 
 private:
-    using NumberType = std::remove_cvref_t<
-        decltype(std::declval<NumberSequenceResponse>().numbers().Get(0))>;
+    template <typename NumberType>
+    using Samplers = std::variant<server::UniformSampler<NumberType>,
+                                  server::NormalSampler<NumberType>,
+                                  server::ExponentialSampler<NumberType>>;
+
+    // Chosen once per transfer from the element type and the distribution
+    using Sampler =
+        std::variant<std::monostate, Samplers<double>, Samplers<float>,
+                     Samplers<int32_t>, Samplers<int64_t>>;
+
+    using DescendingGenerator =
+        std::variant<std::monostate,
+                     server::DescendingUniformGenerator<double>,
+                     server::DescendingUniformGenerator<float>,
+                     server::DescendingUniformGenerator<int32_t>,
+                     server::DescendingUniformGenerator<int64_t>>;
+
+    // Serves one number sequence request of a session. The transfer is
+    // driven by its own coroutine, the dispatcher only hands over the
+    // acknowledgement of the sequence being sent and cancels the timer the
+    // coroutine waits on.
+    //
+    // Numbers are drawn from counter-based streams keyed by the transfer seed
+    // and the number index. A sequence in flight is regenerated for its
+    // retransmission from what its generation could not derive from the
+    // counters: the uniqueness redraws, the shuffled positions of dense
+    // integer requests and, for descending sequences, a copy of the generator
+    // taken before the sequence. They are dropped once the sequence is
+    // acknowledged.
+    struct Transfer {
+        Transfer(const boost::asio::any_io_executor &executor,
+                 const NumberSequenceRequest &request, uint64_t seed)
+            : request{request}, seed{seed}, ack_timer{executor} {}
+
+        NumberSequenceRequest request;
+        uint64_t seed;
+        uint64_t sequence_count{};
+        uint64_t sequence_max_number_count{};
+        // Sequences are sent in groups followed by their parity if set
+        uint32_t fec_group_size{};
+        // Set when the sequences are written to shared memory instead
+        std::optional<utils::SharedRing> shared_ring;
+        // Set once the client asks again without shared memory, as it
+        // cannot open the ring
+        bool shared_memory_declined{false};
+        uint64_t awaited_sequence_index{};
+        std::optional<NumberSequenceAckRequest> ack_request;
+        steady_timer ack_timer;
+        std::string buffer;
+        // Numbers already sent, tracked by their bit pattern
+        std::unordered_set<uint64_t> sent_numbers;
+        Sampler sampler;
+        // Set instead of the sampler for uniform integers too dense for
+        // redrawing duplicates
+        std::optional<server::RangeShuffle> range_shuffle;
+        DescendingGenerator descending_generator;
+        // Guards the regeneration records, which are written on the
+        // generator threads and read on the strand
+        std::mutex regeneration_mutex;
+        // Extra draws of the numbers redrawn for uniqueness, by number index
+        std::unordered_map<uint64_t, uint32_t> redraws;
+        std::unordered_map<uint64_t, DescendingGenerator> checkpoints;
+    };
+
+    struct Session;
+
+    // Publishes the sequences of identical multicast requests once to the
+    // group. Subscribers repair what they missed with unicast NACKs, which
+    // are answered by regenerating the shared transfer, so its regeneration
+    // records are kept until the stream closes.
+    struct Stream {
+        struct Subscriber {
+            std::shared_ptr<Session> session;
+            uint64_t request_id;
+            bool complete{false};
+        };
+
+        Stream(const boost::asio::any_io_executor &executor,
+               uint64_t stream_id, std::shared_ptr<Transfer> transfer)
+            : stream_id{stream_id}, transfer{std::move(transfer)},
+              timer{executor}, pacing_timer{executor} {}
+
+        uint64_t stream_id;
+        std::shared_ptr<Transfer> transfer;
+        std::vector<Subscriber> subscribers;
+        // Identical requests subscribe until the first sequence is published
+        bool started{false};
+        uint64_t published_count{0};
+        std::chrono::steady_clock::time_point last_activity;
+        // Waits out the join window, then the repairs
+        steady_timer timer;
+        steady_timer pacing_timer;
+        std::string buffer;
+    };
+
+    // Opened by the first number sequence request echoing the cookie of the
+    // handshake. Further requests carrying the cookie skip the handshake and
+    // may be pipelined, their transfers run interleaved.
+    struct Session {
+        udp::endpoint endpoint;
+        // Keys the number streams, every transfer adds its request id
+        uint64_t seed;
+        utils::RttEstimator rtt;
+        std::chrono::steady_clock::time_point last_activity;
+        std::unordered_map<uint64_t, std::shared_ptr<Transfer>> transfers;
+        std::unordered_map<uint64_t, std::shared_ptr<Stream>> subscriptions;
+        // Retransmissions of requests already served are ignored, those of
+        // failed requests are answered with their error again
+        std::unordered_set<uint64_t> completed_request_ids;
+        std::unordered_map<uint64_t, NumberSequenceResponse> failed_responses;
+    };
+
+    // Requests over the admission limits wait in a priority queue. Requests
+    // of open sessions go first, then smaller requests, then earlier ones.
+    struct QueuedRequest {
+        NumberSequenceRequest request;
+        udp::endpoint endpoint;
+        std::chrono::steady_clock::time_point deadline;
+        bool has_session;
+        uint64_t arrival_index;
+
+        bool operator<(const QueuedRequest &other) const {
+            return std::tuple{!has_session, request.number_count(),
+                              arrival_index} <
+                   std::tuple{!other.has_session,
+                              other.request.number_count(),
+                              other.arrival_index};
+        }
+    };
 
+    // Receives every request and dispatches it to the session it belongs to.
+    // Transfers run as separate coroutines on the same strand.
     awaitable<void> run() {
-        using namespace protocol;
-
         for (;;) {
             try {
-                const auto version_request =
-                    co_await receive_request<ProtocolVersionRequest>();
+                const auto request = co_await receive_request();
+                const auto endpoint = sender_endpoint_;
+
+                if (const auto *version_request =
+                        utils::get_payload<ProtocolVersionRequest>(request)) {
+                    co_await handle_protocol_version_request(*version_request,
+                                                             endpoint);
+                } else if (const auto *number_request =
+                               utils::get_payload<NumberSequenceRequest>(
+                                   request)) {
+                    co_await handle_number_sequence_request(*number_request,
+                                                            endpoint);
+                } else if (const auto *ack_request =
+                               utils::get_payload<NumberSequenceAckRequest>(
+                                   request)) {
+                    co_await handle_number_sequence_ack_request(*ack_request,
+                                                                endpoint);
+                } else if (const auto *nack_request =
+                               utils::get_payload<NumberSequenceNackRequest>(
+                                   request)) {
+                    handle_number_sequence_nack_request(*nack_request,
+                                                        endpoint);
+                }
+            } catch (std::exception &error) {
+                logger_.log("Exception: {}", error.what());
+            }
+        }
+    }
+
+    awaitable<void>
+    handle_protocol_version_request(const ProtocolVersionRequest &request,
+                                    const udp::endpoint &endpoint) {
+        auto response = create_protocol_version_response(request);
+
+        // Nothing is allocated until the client echoes the cookie
+        if (response.error() == ProtocolVersionError::VERSION_OK) {
+            response.set_session_token(cookie_generator_.issue(endpoint));
+            response.set_shared_memory(request.shared_memory() &&
+                                       is_shared_memory_available(endpoint));
+        }
+
+        co_await send_response(endpoint, response, buffer_);
+    }
 
-                const auto version_response =
-                    create_protocol_version_response(version_request);
-                co_await send_response(version_response);
+    awaitable<void>
+    handle_number_sequence_request(const NumberSequenceRequest &request,
+                                   const udp::endpoint &endpoint) {
+        auto session = find_session(request.session_token(), endpoint);
+        if (!session &&
+            !cookie_generator_.verify(request.session_token(), endpoint)) {
+            NumberSequenceResponse response;
+            response.set_request_id(request.request_id());
+            response.set_error(NumberSequenceError::UNKNOWN_SESSION);
+            response.set_error_message("Invalid or expired session token, "
+                                       "the handshake has to be repeated");
+
+            co_await send_response(endpoint, response, buffer_);
+            co_return;
+        }
 
-                if (version_response.error() !=
-                    ProtocolVersionError::VERSION_OK) {
-                    continue;
+        if (session) {
+            session->last_activity = std::chrono::steady_clock::now();
+
+            // The client retransmits the request until the first sequence
+            // arrives, or the response announcing the shared memory ring
+            if (const auto transfer =
+                    session->transfers.find(request.request_id());
+                transfer != session->transfers.end()) {
+                auto &existing_transfer = *transfer->second;
+
+                if (existing_transfer.shared_ring) {
+                    if (!request.shared_memory()) {
+                        existing_transfer.shared_memory_declined = true;
+                        existing_transfer.ack_timer.cancel();
+                    } else {
+                        co_await send_response(
+                            endpoint,
+                            create_shared_memory_response(existing_transfer),
+                            buffer_);
+                    }
                 }
 
-                const auto number_request =
-                    co_await receive_request<NumberSequenceRequest>();
+                co_return;
+            }
+
+            if (const auto failed_response =
+                    session->failed_responses.find(request.request_id());
+                failed_response != session->failed_responses.end()) {
+                co_await send_response(endpoint, failed_response->second,
+                                       buffer_);
+                co_return;
+            }
+
+            if (session->completed_request_ids.contains(
+                    request.request_id())) {
+                co_return;
+            }
+
+            // The stream response was lost
+            if (const auto subscription =
+                    session->subscriptions.find(request.request_id());
+                subscription != session->subscriptions.end()) {
+                co_await send_response(
+                    endpoint,
+                    create_multicast_stream_response(*subscription->second,
+                                                     request.request_id()),
+                    buffer_);
+                co_return;
+            }
+        }
+
+        // Retransmissions of a queued request keep its place
+        if (is_queued(request, endpoint)) {
+            co_return;
+        }
+
+        if (const auto error_response =
+                validate_number_sequence_request(request)) {
+            logger_.log("Rejected number sequence request\nError: {}",
+                        error_response->error_message());
+            co_await send_response(endpoint, *error_response, buffer_);
+            co_return;
+        }
+
+        if (const auto retry_after = take_client_token(endpoint.address());
+            retry_after != std::chrono::steady_clock::duration::zero()) {
+            co_await reject_number_sequence_request(request, endpoint,
+                                                    retry_after);
+            co_return;
+        }
+
+        if (admission_queue_.empty() &&
+            can_admit(session != nullptr, request)) {
+            co_await admit_number_sequence_request(std::move(session), request,
+                                                   endpoint);
+        } else {
+            co_await enqueue_number_sequence_request(request, endpoint,
+                                                     session != nullptr);
+            co_await admit_queued_requests();
+        }
+    }
+
+    awaitable<void>
+    admit_number_sequence_request(std::shared_ptr<Session> session,
+                                  const NumberSequenceRequest &request,
+                                  const udp::endpoint &endpoint) {
+        // A queued request may find the session opened in the meantime
+        if (!session) {
+            session = find_session(request.session_token(), endpoint);
+        }
+
+        if (!session) {
+            session = open_session(request.session_token(), endpoint);
+        }
+
+        if (request.multicast()) {
+            co_await subscribe_to_stream(session, request);
+            co_return;
+        }
+
+        numbers_in_flight_ += request.number_count();
+
+        auto transfer = std::make_shared<Transfer>(
+            strand_, request, session->seed + request.request_id());
+        session->transfers.emplace(request.request_id(), transfer);
+
+        co_spawn(strand_,
+                 send_number_sequence_responses(session, std::move(transfer)),
+                 detached);
+    }
+
+    bool can_admit(bool has_session,
+                   const NumberSequenceRequest &request) const {
+        if (!has_session && config_.max_session_count() != 0 &&
+            sessions_.size() >= config_.max_session_count()) {
+            return false;
+        }
+
+        return config_.max_numbers_in_flight() == 0 ||
+               numbers_in_flight_ + request.number_count() <=
+                   config_.max_numbers_in_flight();
+    }
+
+    bool is_queued(const NumberSequenceRequest &request,
+                   const udp::endpoint &endpoint) const {
+        return std::ranges::any_of(admission_queue_, [&](const auto &queued) {
+            return queued.endpoint == endpoint &&
+                   queued.request.session_token() == request.session_token() &&
+                   queued.request.request_id() == request.request_id();
+        });
+    }
+
+    // A full queue sheds its lowest priority request, which may be the new
+    // one
+    awaitable<void>
+    enqueue_number_sequence_request(const NumberSequenceRequest &request,
+                                    const udp::endpoint &endpoint,
+                                    bool has_session) {
+        const auto deadline = std::chrono::steady_clock::now() +
+                              config_.admission_queue_timeout();
+        QueuedRequest queued_request{request, endpoint, deadline, has_session,
+                                     next_arrival_index_++};
+
+        if (admission_queue_.size() >= config_.admission_queue_size()) {
+            if (admission_queue_.empty() ||
+                !(queued_request < *admission_queue_.rbegin())) {
+                co_await reject_number_sequence_request(request, endpoint,
+                                                        config_.retry_after());
+                co_return;
+            }
+
+            auto shed_request =
+                admission_queue_.extract(std::prev(admission_queue_.end()));
+            admission_queue_.insert(std::move(queued_request));
+            admission_timer_.cancel();
+
+            co_await reject_number_sequence_request(
+                shed_request.value().request, shed_request.value().endpoint,
+                config_.retry_after());
+            co_return;
+        }
+
+        admission_queue_.insert(std::move(queued_request));
+        admission_timer_.cancel();
+    }
+
+    // Admits queued requests in priority order while the limits allow.
+    // Called whenever a transfer, a stream or a session ends.
+    awaitable<void> admit_queued_requests() {
+        while (!admission_queue_.empty()) {
+            const auto &queued_request = *admission_queue_.begin();
+            auto session = find_session(queued_request.request.session_token(),
+                                        queued_request.endpoint);
+
+            if (!can_admit(session != nullptr, queued_request.request)) {
+                break;
+            }
+
+            auto admitted_request =
+                admission_queue_.extract(admission_queue_.begin());
+            co_await admit_number_sequence_request(
+                std::move(session), admitted_request.value().request,
+                admitted_request.value().endpoint);
+        }
+    }
+
+    // Requests not admitted within the queue timeout are rejected, so that
+    // their clients back off instead of retransmitting
+    awaitable<void> expire_queued_requests() {
+        for (;;) {
+            if (admission_queue_.empty()) {
+                admission_timer_.expires_at(
+                    std::chrono::steady_clock::time_point::max());
+            } else {
+                admission_timer_.expires_at(
+                    std::ranges::min(admission_queue_, {},
+                                     &QueuedRequest::deadline)
+                        .deadline);
+            }
 
-                const auto sequence_count =
-                    get_sequence_count(number_request.number_count());
+            co_await admission_timer_.async_wait();
 
-                for (uint64_t sequence_index{0};
-                     sequence_index < sequence_count; ++sequence_index) {
-                    co_await send_number_sequence_response(
-                        number_request, sequence_index, sequence_count);
+            const auto now = std::chrono::steady_clock::now();
+            std::vector<QueuedRequest> expired_requests;
+
+            for (auto queued_request = admission_queue_.begin();
+                 queued_request != admission_queue_.end();) {
+                if (queued_request->deadline <= now) {
+                    expired_requests.push_back(std::move(
+                        admission_queue_.extract(queued_request++).value()));
+                } else {
+                    ++queued_request;
                 }
-            } catch (std::exception &error) {
-                logger_.log("Exception: {}", error.what());
             }
+
+            for (const auto &expired_request : expired_requests) {
+                co_await reject_number_sequence_request(
+                    expired_request.request, expired_request.endpoint,
+                    config_.retry_after());
+            }
+        }
+    }
+
+    // Returns zero if the client may send another request, otherwise how
+    // long it has to wait
+    std::chrono::steady_clock::duration
+    take_client_token(const boost::asio::ip::address &address) {
+        if (config_.client_rate() == 0.0) {
+            return std::chrono::steady_clock::duration::zero();
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        auto &bucket =
+            client_buckets_
+                .try_emplace(address, config_.client_rate(),
+                             config_.client_burst(), now)
+                .first->second;
+
+        return bucket.take(now);
+    }
+
+    // Sent from several coroutines, hence through its own buffer
+    awaitable<void> reject_number_sequence_request(
+        const NumberSequenceRequest &request, const udp::endpoint &endpoint,
+        std::chrono::steady_clock::duration retry_after) {
+        NumberSequenceResponse response;
+        response.set_request_id(request.request_id());
+        response.set_error(NumberSequenceError::OVERLOADED);
+        response.set_error_message("Server is at capacity");
+        response.set_retry_after_ms(static_cast<uint32_t>(
+            std::chrono::ceil<std::chrono::milliseconds>(retry_after)
+                .count()));
+
+        std::string buffer;
+        co_await send_response(endpoint, response, buffer);
+    }
+
+    awaitable<void> handle_number_sequence_ack_request(
+        const NumberSequenceAckRequest &ack_request,
+        const udp::endpoint &endpoint) {
+        const auto session =
+            find_session(ack_request.session_token(), endpoint);
+        if (!session) {
+            co_return;
+        }
+
+        session->last_activity = std::chrono::steady_clock::now();
+
+        const auto transfer = session->transfers.find(ack_request.request_id());
+        if (transfer == session->transfers.end()) {
+            // The error of a failed request was lost, the client is still
+            // acknowledging its sequences
+            if (const auto failed_response =
+                    session->failed_responses.find(ack_request.request_id());
+                failed_response != session->failed_responses.end()) {
+                co_await send_response(endpoint, failed_response->second,
+                                       buffer_);
+            }
+
+            co_return;
+        }
+
+        // Acknowledgements of retransmitted sequences are dropped
+        auto &awaiting_transfer = *transfer->second;
+        if (ack_request.sequence_index() !=
+            awaiting_transfer.awaited_sequence_index) {
+            co_return;
+        }
+
+        awaiting_transfer.ack_request = ack_request;
+        awaiting_transfer.ack_timer.cancel();
+    }
+
+    void handle_number_sequence_nack_request(
+        const NumberSequenceNackRequest &nack_request,
+        const udp::endpoint &endpoint) {
+        const auto session =
+            find_session(nack_request.session_token(), endpoint);
+        if (!session) {
+            return;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        session->last_activity = now;
+
+        const auto subscription =
+            session->subscriptions.find(nack_request.request_id());
+        if (subscription == session->subscriptions.end()) {
+            return;
+        }
+
+        const auto stream = subscription->second;
+        stream->last_activity = now;
+
+        if (nack_request.complete()) {
+            for (auto &subscriber : stream->subscribers) {
+                if (subscriber.session == session &&
+                    subscriber.request_id == nack_request.request_id()) {
+                    subscriber.complete = true;
+                }
+            }
+
+            if (is_stream_complete(*stream)) {
+                stream->timer.cancel();
+            }
+
+            return;
+        }
+
+        // Sequences not published yet are still to come from the group
+        std::vector<uint64_t> sequence_indices;
+        for (const auto sequence_index : nack_request.sequence_indices()) {
+            if (sequence_index < stream->published_count &&
+                sequence_indices.size() < NACK_MAX_SEQUENCE_COUNT) {
+                sequence_indices.push_back(sequence_index);
+            }
+        }
+
+        if (!sequence_indices.empty()) {
+            co_spawn(strand_,
+                     repair_number_sequences(session, stream,
+                                             nack_request.request_id(),
+                                             std::move(sequence_indices)),
+                     detached);
+        }
+    }
+
+    // Identical requests arriving before a stream starts share it, later
+    // ones open a new stream
+    awaitable<void>
+    subscribe_to_stream(std::shared_ptr<Session> session,
+                        const NumberSequenceRequest &request) {
+        std::shared_ptr<Stream> stream;
+
+        for (const auto &[stream_id, open_stream] : streams_) {
+            const auto &stream_request = open_stream->transfer->request;
+
+            if (!open_stream->started &&
+                stream_request.number_count() == request.number_count() &&
+                stream_request.upper_bound() == request.upper_bound() &&
+                get_lower_bound(stream_request) == get_lower_bound(request) &&
+                stream_request.order() == request.order() &&
+                stream_request.distribution() == request.distribution() &&
+                stream_request.element_type() == request.element_type()) {
+                stream = open_stream;
+                break;
+            }
+        }
+
+        if (!stream) {
+            auto stream_request = request;
+            stream_request.clear_session_token();
+            stream_request.clear_request_id();
+
+            auto transfer = std::make_shared<Transfer>(strand_, stream_request,
+                                                       seed_generator_());
+            init_transfer(*transfer);
+
+            stream = std::make_shared<Stream>(strand_, next_stream_id_++,
+                                              std::move(transfer));
+            streams_.emplace(stream->stream_id, stream);
+            numbers_in_flight_ += request.number_count();
+
+            co_spawn(strand_, publish_stream(stream), detached);
+        }
+
+        stream->subscribers.push_back({session, request.request_id()});
+        session->subscriptions.emplace(request.request_id(), stream);
+
+        // Also called when a queued request is admitted
+        std::string buffer;
+        co_await send_response(
+            session->endpoint,
+            create_multicast_stream_response(*stream, request.request_id()),
+            buffer);
+    }
+
+    // Publishes the sequences paced at the configured rate, then stays open
+    // for repairs until every subscriber completes or falls silent
+    awaitable<void> publish_stream(std::shared_ptr<Stream> stream) {
+        const auto &transfer = stream->transfer;
+        std::optional<std::string> error_message;
+
+        try {
+            stream->timer.expires_after(MULTICAST_JOIN_WINDOW);
+            co_await stream->timer.async_wait();
+            stream->started = true;
+
+            auto sequence_response =
+                co_await generate_number_sequence_response(transfer, 0);
+            auto publish_time = std::chrono::steady_clock::now();
+
+            for (uint64_t sequence_index{1};
+                 sequence_index < transfer->sequence_count; ++sequence_index) {
+                sequence_response = co_await (
+                    publish_number_sequence_response(
+                        *stream, std::move(sequence_response), publish_time) &&
+                    generate_number_sequence_response(transfer,
+                                                      sequence_index));
+                publish_time += multicast_interval_;
+            }
+
+            co_await publish_number_sequence_response(
+                *stream, std::move(sequence_response), publish_time);
+
+            stream->last_activity = std::chrono::steady_clock::now();
+            while (!is_stream_complete(*stream) &&
+                   std::chrono::steady_clock::now() - stream->last_activity <
+                       SESSION_IDLE_TIMEOUT) {
+                stream->timer.expires_at(stream->last_activity +
+                                         SESSION_IDLE_TIMEOUT);
+                co_await stream->timer.async_wait();
+            }
+        } catch (std::exception &error) {
+            logger_.log("Exception: {}", error.what());
+            error_message = error.what();
+        }
+
+        for (const auto &subscriber : stream->subscribers) {
+            if (error_message && !subscriber.complete) {
+                co_await fail_number_sequence_request(
+                    *subscriber.session, transfer->request,
+                    subscriber.request_id, *error_message);
+            }
+
+            subscriber.session->subscriptions.erase(subscriber.request_id);
+            subscriber.session->completed_request_ids.insert(
+                subscriber.request_id);
+        }
+
+        streams_.erase(stream->stream_id);
+        numbers_in_flight_ -= stream->transfer->request.number_count();
+
+        co_await admit_queued_requests();
+    }
+
+    awaitable<void> publish_number_sequence_response(
+        Stream &stream, NumberSequenceResponse sequence_response,
+        std::chrono::steady_clock::time_point publish_time) {
+        stream.pacing_timer.expires_at(publish_time);
+        co_await stream.pacing_timer.async_wait();
+
+        sequence_response.set_stream_id(stream.stream_id);
+        co_await send_response(multicast_endpoint_, sequence_response,
+                               stream.buffer);
+        ++stream.published_count;
+    }
+
+    awaitable<void>
+    repair_number_sequences(std::shared_ptr<Session> session,
+                            std::shared_ptr<Stream> stream, uint64_t request_id,
+                            std::vector<uint64_t> sequence_indices) {
+        std::string buffer;
+
+        try {
+            for (const auto sequence_index : sequence_indices) {
+                auto sequence_response =
+                    co_await regenerate_number_sequence_response(
+                        stream->transfer, sequence_index);
+                sequence_response.set_request_id(request_id);
+                sequence_response.set_stream_id(stream->stream_id);
+
+                co_await send_response(session->endpoint, sequence_response,
+                                       buffer);
+            }
+        } catch (std::exception &error) {
+            logger_.log("Exception: {}", error.what());
+        }
+    }
+
+    static bool is_stream_complete(const Stream &stream) {
+        return std::ranges::all_of(
+            stream.subscribers,
+            [](const auto &subscriber) { return subscriber.complete; });
+    }
+
+    // The next sequence is generated on the generator threads while the
+    // current one waits for its acknowledgement.
+    awaitable<void>
+    send_number_sequence_responses(std::shared_ptr<Session> session,
+                                   std::shared_ptr<Transfer> transfer) {
+        // Kept apart, the transfer is replaced if shared memory is declined
+        const auto request = transfer->request;
+        std::optional<std::string> error_message;
+
+        try {
+            open_shared_ring(*session, *transfer);
+            init_transfer(*transfer);
+
+            if (!transfer->shared_ring) {
+                co_await send_datagram_sequences(*session, transfer);
+            } else {
+                co_await send_shared_memory_sequences(*session, transfer);
+
+                // Nothing was read from the ring, the request is served over
+                // UDP from the start by a new transfer
+                if (transfer->shared_memory_declined) {
+                    logger_.log("Sending request {} over UDP instead of "
+                                "shared memory, the client cannot open the "
+                                "ring",
+                                request.request_id());
+
+                    auto datagram_request = request;
+                    datagram_request.set_shared_memory(false);
+                    transfer = std::make_shared<Transfer>(
+                        strand_, datagram_request, transfer->seed);
+                    session->transfers.insert_or_assign(request.request_id(),
+                                                        transfer);
+
+                    init_transfer(*transfer);
+                    co_await send_datagram_sequences(*session, transfer);
+                }
+            }
+        } catch (std::exception &error) {
+            logger_.log("Exception: {}", error.what());
+            error_message = error.what();
+        }
+
+        // The client is told, instead of waiting for sequences that will not
+        // come, before its retransmissions are answered from the session
+        if (error_message) {
+            // Wakes the client reading the ring, which then takes the error
+            // from the response
+            if (transfer->shared_ring) {
+                transfer->shared_ring->close();
+            }
+
+            co_await fail_number_sequence_request(*session, request,
+                                                  request.request_id(),
+                                                  *error_message);
+        }
+
+        session->transfers.erase(request.request_id());
+        session->completed_request_ids.insert(request.request_id());
+        session->last_activity = std::chrono::steady_clock::now();
+        numbers_in_flight_ -= request.number_count();
+
+        co_await admit_queued_requests();
+    }
+
+    // Answers a request the server failed to serve, now and whenever the
+    // client asks again. The request id is that of the subscriber for
+    // streams, whose request is shared.
+    awaitable<void> fail_number_sequence_request(
+        Session &session, const NumberSequenceRequest &request,
+        uint64_t request_id, std::string_view message) {
+        NumberSequenceResponse response;
+        response.set_request_id(request_id);
+        response.set_number_count(request.number_count());
+        response.set_upper_bound(request.upper_bound());
+        response.set_order(request.order());
+        response.set_element_type(request.element_type());
+        response.set_error(NumberSequenceError::TRANSFER_FAILED);
+        response.set_error_message(std::string{message});
+
+        session.failed_responses.insert_or_assign(request_id, response);
+
+        std::string buffer;
+        try {
+            co_await send_response(session.endpoint, response, buffer);
+        } catch (std::exception &error) {
+            logger_.log("Exception: {}", error.what());
+        }
+    }
+
+    awaitable<void>
+    send_datagram_sequences(Session &session,
+                            std::shared_ptr<Transfer> transfer) {
+        if (transfer->fec_group_size != 0) {
+            for (uint64_t sequence_index{0};
+                 sequence_index < transfer->sequence_count;
+                 sequence_index += transfer->fec_group_size) {
+                co_await send_number_sequence_group(session, transfer,
+                                                    sequence_index);
+            }
+
+            co_return;
+        }
+
+        auto sequence_response =
+            co_await generate_number_sequence_response(transfer, 0);
+
+        for (uint64_t sequence_index{1};
+             sequence_index < transfer->sequence_count; ++sequence_index) {
+            sequence_response = co_await (
+                send_number_sequence_response(session, transfer,
+                                              std::move(sequence_response)) &&
+                generate_number_sequence_response(transfer, sequence_index));
+        }
+
+        co_await send_number_sequence_response(session, transfer,
+                                               std::move(sequence_response));
+    }
+
+    void init_transfer(Transfer &transfer) {
+        const auto &request = transfer.request;
+
+        if (transfer.shared_ring) {
+            transfer.sequence_max_number_count = utils::visit_element_type(
+                request.element_type(), [&]<typename Traits>(Traits) {
+                    return transfer.shared_ring
+                        ->sequence_capacity<typename Traits::value_type>();
+                });
+        } else {
+            transfer.sequence_max_number_count =
+                get_sequence_max_number_count(request.element_type());
+        }
+
+        transfer.sequence_count = get_sequence_count(
+            request.number_count(), transfer.sequence_max_number_count);
+
+        // Streams are repaired by NACKs instead, shared memory loses nothing
+        if (!request.multicast() && !transfer.shared_ring) {
+            transfer.fec_group_size = std::min(request.fec_group_size(),
+                                               config_.fec_max_group_size());
+        }
+
+        if (request.order() == NumberOrder::DESCENDING) {
+            utils::visit_element_type(
+                request.element_type(), [&]<typename Traits>(Traits) {
+                    using NumberType = typename Traits::value_type;
+                    const auto [lower_bound, upper_bound] =
+                        get_bounds<NumberType>(request);
+
+                    transfer.descending_generator.emplace<
+                        server::DescendingUniformGenerator<NumberType>>(
+                        lower_bound, upper_bound, request.number_count(),
+                        transfer.seed);
+                });
+        } else {
+            utils::visit_element_type(
+                request.element_type(), [&]<typename Traits>(Traits) {
+                    using NumberType = typename Traits::value_type;
+                    const auto [lower_bound, upper_bound] =
+                        get_bounds<NumberType>(request);
+
+                    if constexpr (std::integral<NumberType>) {
+                        if (request.distribution() ==
+                                Distribution::DISTRIBUTION_UNIFORM &&
+                            static_cast<double>(request.number_count()) >
+                                get_max_sampled_number_count<NumberType>(
+                                    request)) {
+                            transfer.range_shuffle.emplace(
+                                static_cast<uint64_t>(upper_bound) -
+                                    static_cast<uint64_t>(lower_bound) + 1,
+                                transfer.seed);
+                            return;
+                        }
+                    }
+
+                    transfer.sampler.emplace<Samplers<NumberType>>(
+                        create_sampler<NumberType>(request.distribution(),
+                                                   lower_bound, upper_bound));
+                    transfer.sent_numbers.reserve(request.number_count());
+                });
+        }
+    }
+
+    template <typename NumberType>
+    static Samplers<NumberType> create_sampler(Distribution distribution,
+                                               NumberType lower_bound,
+                                               NumberType upper_bound) {
+        switch (distribution) {
+        case Distribution::DISTRIBUTION_NORMAL:
+            return server::NormalSampler<NumberType>{lower_bound, upper_bound};
+        case Distribution::DISTRIBUTION_EXPONENTIAL:
+            return server::ExponentialSampler<NumberType>{lower_bound,
+                                                          upper_bound};
+        default:
+            return server::UniformSampler<NumberType>{lower_bound,
+                                                      upper_bound};
         }
     }
 
+    // The generator coroutine shares the transfer, which outlives it even
+    // if the send fails first
+    awaitable<NumberSequenceResponse>
+    generate_number_sequence_response(std::shared_ptr<Transfer> transfer,
+                                      uint64_t sequence_index) {
+        co_return co_await co_spawn(
+            generator_context_,
+            [this, transfer,
+             sequence_index]() -> awaitable<NumberSequenceResponse> {
+                co_return create_number_sequence_response(
+                    *transfer, sequence_index, false);
+            },
+            boost::asio::use_awaitable);
+    }
+
+    awaitable<NumberSequenceResponse>
+    regenerate_number_sequence_response(std::shared_ptr<Transfer> transfer,
+                                        uint64_t sequence_index) {
+        co_return co_await co_spawn(
+            generator_context_,
+            [this, transfer,
+             sequence_index]() -> awaitable<NumberSequenceResponse> {
+                co_return create_number_sequence_response(
+                    *transfer, sequence_index, true);
+            },
+            boost::asio::use_awaitable);
+    }
+
+    // The response is released once sent and regenerated for every
+    // retransmission, so only the regeneration records of a sequence stay in
+    // memory while it waits for its acknowledgement
     awaitable<void>
-    send_number_sequence_response(const NumberSequenceRequest &sequence_request,
-                                  uint64_t sequence_index,
-                                  uint64_t sequence_count) {
-        const auto sequence_response = create_number_sequence_response(
-            sequence_request, sequence_index, sequence_count);
+    send_number_sequence_response(Session &session,
+                                  std::shared_ptr<Transfer> transfer_pointer,
+                                  NumberSequenceResponse sequence_response) {
+        auto &transfer = *transfer_pointer;
+        const auto sequence_index = sequence_response.sequence_index();
+        const auto checksum = sequence_response.checksum();
+        transfer.awaited_sequence_index = sequence_index;
+        transfer.ack_request.reset();
 
         for (uint8_t retry_index{0};
              retry_index <= SEQUENCE_RESPONSE_MAX_RETRIES_COUNT;
              ++retry_index) {
-            co_await send_response(sequence_response);
+            if (retry_index != 0) {
+                sequence_response =
+                    co_await regenerate_number_sequence_response(
+                        transfer_pointer, sequence_index);
+            }
+
+            const auto send_time = std::chrono::steady_clock::now();
+            transfer.ack_timer.expires_after(session.rtt.timeout());
+            co_await send_response(session.endpoint, sequence_response,
+                                   transfer.buffer);
+            sequence_response = NumberSequenceResponse{};
+
+            if (!transfer.ack_request) {
+                co_await transfer.ack_timer.async_wait();
+            }
+
+            if (!transfer.ack_request) {
+                logger_.log("Timed out waiting for acknowledgement of number "
+                            "sequence {} of request {}. Timeout: {}. Retry: {}",
+                            sequence_index, transfer.request.request_id(),
+                            std::chrono::duration_cast<
+                                std::chrono::milliseconds>(
+                                session.rtt.timeout()),
+                            retry_index);
+                session.rtt.backoff();
+                continue;
+            }
+
+            if (retry_index == 0) {
+                session.rtt.add_sample(std::chrono::steady_clock::now() -
+                                       send_time);
+            }
 
             const auto ack_request =
-                co_await receive_request<NumberSequenceAckRequest>();
+                *std::exchange(transfer.ack_request, std::nullopt);
 
             if (ack_request.ack() == NumberSequenceAck::ACK_OK) {
+                release_number_sequence(transfer, sequence_index);
                 co_return;
             } else {
                 logger_.log(
                     "Failed to acknowledge number sequence {}. Expected "
                     "checksum: {}. Actual checksum: {}. Retry: {}",
-                    sequence_response.sequence_index(),
-                    sequence_response.checksum(), ack_request.checksum(),
+                    sequence_index, checksum, ack_request.checksum(),
                     retry_index);
             }
         }
+
+        throw std::runtime_error{
+            std::format("Number sequence {} of request {} was not "
+                        "acknowledged after {} retries",
+                        sequence_index, transfer.request.request_id(),
+                        SEQUENCE_RESPONSE_MAX_RETRIES_COUNT)};
+    }
+
+    // Sends the sequences of a group back to back, each one generated while
+    // the previous one is sent, and follows them with their parity. The
+    // client acknowledges the group once it has all its sequences, rebuilding
+    // a single lost one from the parity. The sequences it reports missing are
+    // sent again, the whole group if the acknowledgement times out.
+    awaitable<void>
+    send_number_sequence_group(Session &session,
+                               std::shared_ptr<Transfer> transfer_pointer,
+                               uint64_t first_sequence_index) {
+        auto &transfer = *transfer_pointer;
+        const auto group_sequence_count =
+            std::min<uint64_t>(transfer.fec_group_size,
+                               transfer.sequence_count - first_sequence_index);
+        transfer.awaited_sequence_index = first_sequence_index;
+        transfer.ack_request.reset();
+
+        std::vector<uint64_t> group_sequence_indices(group_sequence_count);
+        std::iota(group_sequence_indices.begin(), group_sequence_indices.end(),
+                  first_sequence_index);
+        auto sequence_indices = group_sequence_indices;
+
+        for (uint8_t retry_index{0};
+             retry_index <= SEQUENCE_RESPONSE_MAX_RETRIES_COUNT;
+             ++retry_index) {
+            const auto send_time = std::chrono::steady_clock::now();
+            co_await send_number_sequence_group_responses(
+                session, transfer_pointer, sequence_indices, retry_index != 0,
+                sequence_indices.size() == group_sequence_count);
+
+            transfer.ack_timer.expires_after(session.rtt.timeout());
+            if (!transfer.ack_request) {
+                co_await transfer.ack_timer.async_wait();
+            }
+
+            if (!transfer.ack_request) {
+                logger_.log("Timed out waiting for acknowledgement of number "
+                            "sequence group {} of request {}. Timeout: {}. "
+                            "Retry: {}",
+                            first_sequence_index, transfer.request.request_id(),
+                            std::chrono::duration_cast<
+                                std::chrono::milliseconds>(
+                                session.rtt.timeout()),
+                            retry_index);
+                session.rtt.backoff();
+                sequence_indices = group_sequence_indices;
+                continue;
+            }
+
+            if (retry_index == 0) {
+                session.rtt.add_sample(std::chrono::steady_clock::now() -
+                                       send_time);
+            }
+
+            const auto ack_request =
+                *std::exchange(transfer.ack_request, std::nullopt);
+
+            if (ack_request.ack() == NumberSequenceAck::ACK_OK) {
+                for (const auto sequence_index : group_sequence_indices) {
+                    release_number_sequence(transfer, sequence_index);
+                }
+
+                co_return;
+            }
+
+            sequence_indices.clear();
+            for (const auto sequence_index :
+                 ack_request.missing_sequence_indices()) {
+                const bool in_group =
+                    sequence_index >= first_sequence_index &&
+                    sequence_index - first_sequence_index <
+                        group_sequence_count;
+
+                if (in_group && std::ranges::find(sequence_indices,
+                                                  sequence_index) ==
+                                    sequence_indices.end()) {
+                    sequence_indices.push_back(sequence_index);
+                }
+            }
+
+            if (sequence_indices.empty()) {
+                sequence_indices = group_sequence_indices;
+            }
+
+            logger_.log("Failed to rebuild {} number sequences of group {} of "
+                        "request {}. Retry: {}",
+                        sequence_indices.size(), first_sequence_index,
+                        transfer.request.request_id(), retry_index);
+        }
+
+        throw std::runtime_error{
+            std::format("Number sequence group {} of request {} was not "
+                        "acknowledged after {} retries",
+                        first_sequence_index, transfer.request.request_id(),
+                        SEQUENCE_RESPONSE_MAX_RETRIES_COUNT)};
+    }
+
+    // Sequences sent again are regenerated, the parity is only sent along
+    // the whole group
+    awaitable<void> send_number_sequence_group_responses(
+        Session &session, std::shared_ptr<Transfer> transfer_pointer,
+        const std::vector<uint64_t> &sequence_indices, bool regenerate,
+        bool send_parity) {
+        auto &transfer = *transfer_pointer;
+        const auto create_response = [&](uint64_t sequence_index) {
+            return regenerate ? regenerate_number_sequence_response(
+                                    transfer_pointer, sequence_index)
+                              : generate_number_sequence_response(
+                                    transfer_pointer, sequence_index);
+        };
+
+        utils::XorParity parity;
+        auto sequence_response =
+            co_await create_response(sequence_indices.front());
+
+        for (size_t index{1}; index <= sequence_indices.size(); ++index) {
+            if (send_parity) {
+                add_parity(parity, sequence_response);
+            }
+
+            if (index == sequence_indices.size()) {
+                co_await send_response(session.endpoint, sequence_response,
+                                       transfer.buffer);
+                break;
+            }
+
+            sequence_response = co_await (
+                send_response(session.endpoint, sequence_response,
+                              transfer.buffer) &&
+                create_response(sequence_indices[index]));
+        }
+
+        if (send_parity) {
+            co_await send_response(
+                session.endpoint,
+                create_number_sequence_parity_response(
+                    transfer, sequence_indices.front(),
+                    sequence_indices.size(), parity),
+                transfer.buffer);
+        }
+    }
+
+    static void add_parity(utils::XorParity &parity,
+                           const NumberSequenceResponse &response) {
+        utils::visit_element_type(
+            response.element_type(), [&]<typename Traits>(Traits) {
+                const auto &numbers = Traits::numbers(response);
+                parity.add(std::span{numbers.data(),
+                                     static_cast<size_t>(numbers.size())},
+                           response.checksum());
+            });
+    }
+
+    // Only clients on the same host can open the ring, and they reach the
+    // server over loopback
+    bool is_shared_memory_available(const udp::endpoint &endpoint) const {
+        return utils::SHARED_MEMORY_SUPPORTED &&
+               config_.shared_memory_slot_count() != 0 &&
+               endpoint.address().is_loopback();
+    }
+
+    // The transfer falls back to datagrams if the ring cannot be created
+    void open_shared_ring(const Session &session, Transfer &transfer) {
+        const auto &request = transfer.request;
+        if (!request.shared_memory() || request.multicast() ||
+            !is_shared_memory_available(session.endpoint)) {
+            return;
+        }
+
+        try {
+            transfer.shared_ring = utils::SharedRing::create(
+                config_.shared_memory_slot_count(),
+                config_.shared_memory_sequence_size());
+        } catch (std::exception &error) {
+            logger_.log("Sending request {} over UDP instead of shared "
+                        "memory. Error: {}",
+                        request.request_id(), error.what());
+        }
+    }
+
+    // Writes the sequences to the shared memory ring, each one generated
+    // while the previous one is written, and waits for the client to
+    // acknowledge the last one. Nothing is lost in shared memory, so no
+    // sequence is regenerated. The response announcing the ring is repeated
+    // while the acknowledgement is missing. Returns early once the client
+    // declines the ring.
+    awaitable<void>
+    send_shared_memory_sequences(Session &session,
+                                 std::shared_ptr<Transfer> transfer_pointer) {
+        auto &transfer = *transfer_pointer;
+        const auto shared_memory_response =
+            create_shared_memory_response(transfer);
+        transfer.awaited_sequence_index = transfer.sequence_count - 1;
+        transfer.ack_request.reset();
+
+        co_await send_response(session.endpoint, shared_memory_response,
+                               transfer.buffer);
+
+        auto sequence_response =
+            co_await generate_number_sequence_response(transfer_pointer, 0);
+
+        for (uint64_t sequence_index{1};
+             sequence_index < transfer.sequence_count; ++sequence_index) {
+            sequence_response = co_await (
+                write_shared_memory_sequence(transfer_pointer,
+                                             std::move(sequence_response)) &&
+                generate_number_sequence_response(transfer_pointer,
+                                                  sequence_index));
+
+            if (transfer.shared_memory_declined) {
+                co_return;
+            }
+        }
+
+        co_await write_shared_memory_sequence(transfer_pointer,
+                                              std::move(sequence_response));
+
+        for (uint8_t retry_index{0};
+             retry_index <= SEQUENCE_RESPONSE_MAX_RETRIES_COUNT;
+             ++retry_index) {
+            if (retry_index != 0) {
+                co_await send_response(session.endpoint,
+                                       shared_memory_response, transfer.buffer);
+            }
+
+            transfer.ack_timer.expires_after(session.rtt.timeout());
+            if (!transfer.ack_request && !transfer.shared_memory_declined) {
+                co_await transfer.ack_timer.async_wait();
+            }
+
+            if (transfer.ack_request || transfer.shared_memory_declined) {
+                co_return;
+            }
+
+            logger_.log("Timed out waiting for acknowledgement of shared "
+                        "memory request {}. Timeout: {}. Retry: {}",
+                        transfer.request.request_id(),
+                        std::chrono::duration_cast<std::chrono::milliseconds>(
+                            session.rtt.timeout()),
+                        retry_index);
+            session.rtt.backoff();
+        }
+
+        throw std::runtime_error{
+            std::format("Shared memory request {} was not acknowledged after "
+                        "{} retries",
+                        transfer.request.request_id(),
+                        SEQUENCE_RESPONSE_MAX_RETRIES_COUNT)};
     }
 
-    template <typename RequestType> awaitable<RequestType> receive_request() {
+    // Waits for a free slot and writes the sequence on the waiter threads,
+    // so that the generator threads only generate. The wait is cut into
+    // short intervals, so that a client falling behind does not hold a
+    // waiter from the other rings for long. A declined ring is left
+    // unwritten.
+    awaitable<void>
+    write_shared_memory_sequence(std::shared_ptr<Transfer> transfer,
+                                 NumberSequenceResponse sequence_response) {
+        const auto deadline =
+            std::chrono::steady_clock::now() + SHARED_MEMORY_TIMEOUT;
+
+        for (;;) {
+            if (transfer->shared_memory_declined) {
+                co_return;
+            }
+
+            const bool written = co_await co_spawn(
+                *shared_memory_waiter_,
+                [transfer, &sequence_response]() -> awaitable<bool> {
+                    auto &ring = *transfer->shared_ring;
+                    if (!ring.wait_writable(SHARED_MEMORY_WAIT_INTERVAL)) {
+                        co_return false;
+                    }
+
+                    utils::visit_element_type(
+                        sequence_response.element_type(),
+                        [&]<typename Traits>(Traits) {
+                            const auto &numbers =
+                                Traits::numbers(sequence_response);
+                            ring.write(sequence_response.sequence_index(),
+                                       std::span{numbers.data(),
+                                                 static_cast<size_t>(
+                                                     numbers.size())},
+                                       sequence_response.checksum());
+                        });
+
+                    co_return true;
+                },
+                boost::asio::use_awaitable);
+
+            if (written) {
+                break;
+            }
+
+            if (transfer->shared_ring->is_closed()) {
+                throw std::runtime_error{std::format(
+                    "Client closed the shared memory ring of request {}",
+                    transfer->request.request_id())};
+            }
+
+            if (std::chrono::steady_clock::now() >= deadline) {
+                throw std::runtime_error{std::format(
+                    "Client stopped reading request {} from shared memory",
+                    transfer->request.request_id())};
+            }
+        }
+
+        release_number_sequence(*transfer, sequence_response.sequence_index());
+    }
+
+    std::shared_ptr<Session> open_session(uint64_t session_token,
+                                          const udp::endpoint &endpoint) {
+        const auto [session, inserted] = sessions_.try_emplace(
+            session_token,
+            std::make_shared<Session>(endpoint, seed_generator_(),
+                                      create_rtt_estimator(),
+                                      std::chrono::steady_clock::now()));
+
+        if (!inserted) {
+            throw std::runtime_error{std::format(
+                "Session token {} is already in use by {}", session_token,
+                session->second->endpoint.address().to_string())};
+        }
+
+        return session->second;
+    }
+
+    // Tokens are only valid from the endpoint that performed the handshake,
+    // which also guards against the rare collision of two cookies
+    std::shared_ptr<Session> find_session(uint64_t session_token,
+                                          const udp::endpoint &endpoint) {
+        const auto session = sessions_.find(session_token);
+        if (session == sessions_.end() ||
+            session->second->endpoint != endpoint) {
+            return nullptr;
+        }
+
+        return session->second;
+    }
+
+    // Sessions without transfers or subscriptions are closed once their
+    // client has been silent for SESSION_IDLE_TIMEOUT
+    awaitable<void> expire_sessions() {
+        steady_timer timer{strand_};
+
+        for (;;) {
+            timer.expires_after(SESSION_IDLE_TIMEOUT);
+            co_await timer.async_wait();
+
+            const auto now = std::chrono::steady_clock::now();
+            std::erase_if(sessions_, [&](const auto &entry) {
+                const auto &session = *entry.second;
+                return session.transfers.empty() &&
+                       session.subscriptions.empty() &&
+                       now - session.last_activity >= SESSION_IDLE_TIMEOUT;
+            });
+            std::erase_if(client_buckets_, [&](const auto &entry) {
+                return entry.second.is_full(now);
+            });
+
+            co_await admit_queued_requests();
+        }
+    }
+
+    awaitable<Request> receive_request() {
         buffer_.resize(buffer_.capacity());
         const auto [request_error, request_length] =
             co_await socket_.async_receive_from(
@@ -142,7 +1479,7 @@ private:
         }
 
         buffer_.resize(request_length);
-        RequestType request;
+        Request request;
         request.ParseFromString(buffer_);
 
         logger_.log("Received request from {}\nRequest: {}",
@@ -151,17 +1488,19 @@ private:
         co_return request;
     }
 
+    // Transfers send concurrently, each through its own buffer
     template <typename ResponseType>
-    awaitable<void> send_response(const ResponseType &response) {
+    awaitable<void> send_response(const udp::endpoint &endpoint,
+                                  const ResponseType &response,
+                                  std::string &buffer) {
         logger_.log("Sending response to {}\nResponse: {}",
-                    sender_endpoint_.address().to_v4().to_string(), response);
+                    endpoint.address().to_v4().to_string(), response);
 
-        buffer_.clear();
-        response.SerializeToString(&buffer_);
+        buffer.clear();
+        utils::make_response(response).SerializeToString(&buffer);
 
         auto [response_error, response_length] = co_await socket_.async_send_to(
-            boost::asio::buffer(buffer_.data(), buffer_.size()),
-            sender_endpoint_);
+            boost::asio::buffer(buffer.data(), buffer.size()), endpoint);
 
         if (response_error) {
             throw std::runtime_error{
@@ -207,61 +1546,228 @@ private:
         return response;
     }
 
+    MulticastStreamResponse
+    create_multicast_stream_response(const Stream &stream,
+                                     uint64_t request_id) const {
+        MulticastStreamResponse response;
+        response.set_request_id(request_id);
+        response.set_stream_id(stream.stream_id);
+        response.set_group_address(multicast_endpoint_.address().to_string());
+        response.set_port(multicast_endpoint_.port());
+        response.set_sequence_count(stream.transfer->sequence_count);
+
+        return response;
+    }
+
+    SharedMemoryResponse
+    create_shared_memory_response(const Transfer &transfer) const {
+        SharedMemoryResponse response;
+        response.set_request_id(transfer.request.request_id());
+        response.set_path(transfer.shared_ring->path());
+        response.set_sequence_count(transfer.sequence_count);
+        response.set_sequence_max_number_count(
+            transfer.sequence_max_number_count);
+
+        return response;
+    }
+
+    // Returns the error response for a request that cannot be served
+    std::optional<NumberSequenceResponse>
+    validate_number_sequence_request(const NumberSequenceRequest &request) {
+        NumberSequenceResponse response;
+        response.set_request_id(request.request_id());
+        response.set_number_count(request.number_count());
+        response.set_upper_bound(request.upper_bound());
+        response.set_order(request.order());
+        response.set_element_type(request.element_type());
+
+        const auto validate = [&]<typename Traits>(Traits) {
+            using NumberType = typename Traits::value_type;
+
+            const auto lower_bound = get_lower_bound(request);
+            const auto max_number_count = std::floor(request.upper_bound()) -
+                                          std::ceil(lower_bound) + 1;
+
+            if (!request.has_lower_bound() && !(request.upper_bound() >= 0)) {
+                response.set_error(NumberSequenceError::INVALID_UPPER_BOUND);
+                response.set_error_message(
+                    "Upper bound must be greater than zero");
+            } else if (!(request.upper_bound() >= lower_bound)) {
+                response.set_error(NumberSequenceError::INVALID_LOWER_BOUND);
+                response.set_error_message(
+                    "Lower bound must not exceed the upper bound");
+            } else if (request.upper_bound() >
+                       get_max_upper_bound<NumberType>()) {
+                response.set_error(NumberSequenceError::INVALID_UPPER_BOUND);
+                response.set_error_message(std::format(
+                    "Upper bound exceeds the range of {}", Traits::name));
+            } else if (lower_bound < -get_max_upper_bound<NumberType>()) {
+                response.set_error(NumberSequenceError::INVALID_LOWER_BOUND);
+                response.set_error_message(std::format(
+                    "Lower bound exceeds the range of {}", Traits::name));
+            } else if (request.number_count() == 0) {
+                response.set_error(NumberSequenceError::INVALID_NUMBER_COUNT);
+                response.set_error_message(
+                    "Number count must be greater than zero");
+            } else if (std::integral<NumberType> &&
+                       static_cast<double>(request.number_count()) >
+                           max_number_count) {
+                response.set_error(NumberSequenceError::INVALID_NUMBER_COUNT);
+                response.set_error_message(std::format(
+                    "Bounds allow at most {} unique {} numbers",
+                    std::max(max_number_count, 0.0), Traits::name));
+            } else if (request.order() != NumberOrder::DESCENDING &&
+                       !(std::integral<NumberType> &&
+                         request.distribution() ==
+                             Distribution::DISTRIBUTION_UNIFORM) &&
+                       static_cast<double>(request.number_count()) >
+                           get_max_sampled_number_count<NumberType>(
+                               request)) {
+                response.set_error(NumberSequenceError::INVALID_NUMBER_COUNT);
+                response.set_error_message(std::format(
+                    "Bounds and distribution allow at most {} unique {} "
+                    "numbers",
+                    get_max_sampled_number_count<NumberType>(request),
+                    Traits::name));
+            }
+        };
+
+        utils::visit_element_type(request.element_type(), validate);
+
+        if (response.error() == NumberSequenceError::SEQUENCE_OK) {
+            if (!Distribution_IsValid(request.distribution())) {
+                response.set_error(NumberSequenceError::INVALID_DISTRIBUTION);
+                response.set_error_message("Unsupported distribution");
+            } else if (request.order() == NumberOrder::DESCENDING &&
+                       request.distribution() !=
+                           Distribution::DISTRIBUTION_UNIFORM) {
+                response.set_error(NumberSequenceError::INVALID_DISTRIBUTION);
+                response.set_error_message("Descending sequences are only "
+                                           "generated for the uniform "
+                                           "distribution");
+            }
+        }
+
+        if (response.error() == NumberSequenceError::SEQUENCE_OK &&
+            request.multicast() && multicast_endpoint_.port() == 0) {
+            response.set_error(NumberSequenceError::MULTICAST_UNAVAILABLE);
+            response.set_error_message(
+                "Multicast streams are not enabled on the server");
+        }
+
+        // Such a request could never be admitted
+        if (response.error() == NumberSequenceError::SEQUENCE_OK &&
+            config_.max_numbers_in_flight() != 0 &&
+            request.number_count() > config_.max_numbers_in_flight()) {
+            response.set_error(NumberSequenceError::INVALID_NUMBER_COUNT);
+            response.set_error_message(
+                std::format("Number count exceeds the server limit of {}",
+                            config_.max_numbers_in_flight()));
+        }
+
+        if (response.error() == NumberSequenceError::SEQUENCE_OK) {
+            return std::nullopt;
+        }
+
+        return response;
+    }
+
     NumberSequenceResponse
-    create_number_sequence_response(const NumberSequenceRequest &request,
-                                    uint64_t sequence_index,
-                                    uint64_t sequence_count) {
+    create_number_sequence_response(Transfer &transfer,
+                                    uint64_t sequence_index, bool regenerate) {
+        const auto &request = transfer.request;
+        const auto sequence_count = transfer.sequence_count;
         NumberSequenceResponse response;
 
+        response.set_request_id(request.request_id());
         response.set_number_count(request.number_count());
         response.set_upper_bound(request.upper_bound());
         response.set_sequence_index(sequence_index);
         response.set_sequence_count(sequence_count);
+        response.set_order(request.order());
+        response.set_element_type(request.element_type());
+        response.set_fec_group_size(transfer.fec_group_size);
 
-        auto sequence_number_count = get_sequence_max_number_count();
+        auto sequence_number_count = transfer.sequence_max_number_count;
         if (sequence_index == (sequence_count - 1)) {
             sequence_number_count =
-                request.number_count() % sequence_number_count;
+                request.number_count() - sequence_index * sequence_number_count;
         }
 
         response.set_sequence_number_count(sequence_number_count);
 
-        if (request.upper_bound() < 0) {
-            response.set_error(NumberSequenceError::INVALID_UPPER_BOUND);
-            response.set_error_message("Upper bound must be greater than zero");
+        utils::visit_element_type(
+            request.element_type(), [&]<typename Traits>(Traits) {
+                Traits::mutable_numbers(response)->Reserve(
+                    sequence_number_count);
+
+                if (request.order() == NumberOrder::DESCENDING) {
+                    add_descending_numbers<Traits>(transfer, response,
+                                                   regenerate);
+                } else if (regenerate) {
+                    readd_random_numbers<Traits>(transfer, response);
+                } else {
+                    add_random_numbers<Traits>(transfer, response);
+                }
 
-            return response;
-        }
+                response.set_checksum(
+                    utils::calculate_checksum(Traits::numbers(response)));
+            });
 
-        response.mutable_numbers()->Reserve(sequence_number_count);
+        return response;
+    }
 
-        add_random_numbers(response);
-        response.set_checksum(utils::calculate_checksum(response.numbers()));
+    NumberSequenceParityResponse create_number_sequence_parity_response(
+        const Transfer &transfer, uint64_t first_sequence_index,
+        uint64_t group_sequence_count, const utils::XorParity &parity) {
+        NumberSequenceParityResponse response;
+        response.set_request_id(transfer.request.request_id());
+        response.set_sequence_index(first_sequence_index);
+        response.set_group_sequence_count(
+            static_cast<uint32_t>(group_sequence_count));
+        response.set_sequence_count(transfer.sequence_count);
+        response.set_number_count_parity(parity.number_count());
+        response.set_checksum_parity(parity.checksum());
+        response.set_parity(parity.bytes());
 
         return response;
     }
 
-    uint64_t get_sequence_max_number_count() {
-        NumberSequenceResponse response;
-        response.set_number_count(0);
-        response.set_upper_bound(0);
-        response.set_sequence_index(0);
-        response.set_sequence_count(0);
-        response.set_sequence_number_count(0);
-        response.set_checksum(0);
+    uint64_t get_sequence_max_number_count(ElementType element_type) {
+        // Every header field is set to its longest encoding
+        const auto max_value = std::numeric_limits<uint64_t>::max();
+
+        Response envelope;
+        auto &response = *envelope.mutable_number_sequence_response();
+        response.set_request_id(max_value);
+        response.set_stream_id(max_value);
+        response.set_number_count(max_value);
+        response.set_upper_bound(std::numeric_limits<double>::max());
+        response.set_sequence_index(max_value);
+        response.set_sequence_count(max_value);
+        response.set_sequence_number_count(max_value);
+        response.set_checksum(max_value);
+        response.set_order(NumberOrder::DESCENDING);
+        response.set_element_type(element_type);
+        response.set_fec_group_size(std::numeric_limits<uint32_t>::max());
         response.clear_error();
         response.clear_error_message();
 
-        const size_t number_type_size = sizeof(NumberType);
-        const size_t overhead_per_number = 2;
-
-        return ((MESSAGE_MAX_SIZE - response.ByteSizeLong()) /
-                (number_type_size + overhead_per_number));
+        // Tag and two byte length of the packed numbers field, plus the
+        // second length byte of the envelope once it exceeds 127 bytes
+        const size_t numbers_field_overhead{4};
+        const size_t number_type_size = utils::visit_element_type(
+            element_type, []<typename Traits>(Traits) {
+                return sizeof(typename Traits::value_type);
+            });
+
+        return ((MESSAGE_MAX_SIZE - envelope.ByteSizeLong() -
+                 numbers_field_overhead) /
+                number_type_size);
     }
 
-    uint64_t get_sequence_count(uint64_t number_count) {
-        const auto sequence_max_number_count = get_sequence_max_number_count();
-
+    static uint64_t get_sequence_count(uint64_t number_count,
+                                       uint64_t sequence_max_number_count) {
         auto sequence_count = (number_count / sequence_max_number_count);
         if ((number_count % sequence_max_number_count) != 0) {
             ++sequence_count;
@@ -270,54 +1776,303 @@ private:
         return sequence_count;
     }
 
-    void add_random_numbers(NumberSequenceResponse &response) {
-        auto number_count = response.sequence_number_count();
-        const auto upper_bound = response.upper_bound();
+    // The range is [-upper_bound, upper_bound] unless the request gives its
+    // lower bound, as a client dividing a job across servers does
+    static double get_lower_bound(const NumberSequenceRequest &request) {
+        return request.has_lower_bound() ? request.lower_bound()
+                                         : -request.upper_bound();
+    }
 
-        std::random_device device;
-        std::mt19937 generator{device()};
-        std::uniform_real_distribution<double> distribution{-upper_bound,
-                                                            upper_bound};
+    // Integer bounds are rounded towards the inside of the range
+    template <typename NumberType>
+    static std::pair<NumberType, NumberType>
+    get_bounds(const NumberSequenceRequest &request) {
+        const auto lower_bound = get_lower_bound(request);
+
+        if constexpr (std::integral<NumberType>) {
+            return {static_cast<NumberType>(std::ceil(lower_bound)),
+                    static_cast<NumberType>(std::floor(request.upper_bound()))};
+        } else {
+            return {static_cast<NumberType>(lower_bound),
+                    static_cast<NumberType>(request.upper_bound())};
+        }
+    }
 
-        auto &client_numbers = senders_[sender_endpoint_];
-        const size_t retries_count{10};
+    // Duplicates are redrawn, which stays cheap while the numbers sent take
+    // at most MAX_REJECTION_DENSITY of the probability. Uniform integers
+    // beyond it are shuffled instead.
+    template <typename NumberType>
+    static double
+    get_max_sampled_number_count(const NumberSequenceRequest &request) {
+        const auto [lower_bound, upper_bound] = get_bounds<NumberType>(request);
+        const auto max_probability = std::visit(
+            [](const auto &sampler) { return sampler.max_probability(); },
+            create_sampler<NumberType>(request.distribution(), lower_bound,
+                                       upper_bound));
+
+        return std::max(std::floor(MAX_REJECTION_DENSITY / max_probability),
+                        1.0);
+    }
 
-        while (number_count--) {
-            auto number = distribution(generator);
+    template <typename NumberType> static double get_max_upper_bound() {
+        if constexpr (std::integral<NumberType>) {
+            // Largest double below 2^digits, the first value out of range
+            return std::nextafter(
+                std::ldexp(1.0, std::numeric_limits<NumberType>::digits), 0.0);
+        } else {
+            return std::numeric_limits<NumberType>::max();
+        }
+    }
+
+    // The sequence is sampled in one batch, dispatched on the sampler of
+    // the transfer once, and then checked for uniqueness. A number already
+    // sent is redrawn from the rest of its stream until it is new, which
+    // validation keeps to a few draws.
+    template <typename Traits>
+    void add_random_numbers(Transfer &transfer,
+                            NumberSequenceResponse &response) {
+        using NumberType = typename Traits::value_type;
+
+        auto &numbers = *Traits::mutable_numbers(response);
+
+        if constexpr (std::integral<NumberType>) {
+            if (transfer.range_shuffle) {
+                const auto lower_bound =
+                    get_bounds<NumberType>(transfer.request).first;
+
+                for (uint64_t index{0};
+                     index < response.sequence_number_count(); ++index) {
+                    std::lock_guard lock{transfer.regeneration_mutex};
+                    numbers.Add(get_shuffled_number(
+                        lower_bound, (*transfer.range_shuffle)()));
+                }
+
+                return;
+            }
+        }
 
-            for (size_t retry_index{0};
-                 retry_index < retries_count && client_numbers.contains(number);
-                 ++retry_index) {
-                number = distribution(generator);
+        numbers.Resize(static_cast<int>(response.sequence_number_count()),
+                       NumberType{});
+
+        const auto first_number_index =
+            response.sequence_index() * transfer.sequence_max_number_count;
+
+        std::visit(
+            [&](const auto &sampler) {
+                const std::span<NumberType> sequence{numbers.mutable_data(),
+                                                     numbers.size()};
+                server::sample_batch(sampler, sequence, transfer.seed,
+                                     first_number_index);
+
+                for (size_t index{0}; index < sequence.size(); ++index) {
+                    auto &number = sequence[index];
+
+                    if (transfer.sent_numbers
+                            .insert(utils::get_bit_pattern(number))
+                            .second) {
+                        continue;
+                    }
+
+                    const auto number_index = first_number_index + index;
+                    server::CounterEngine engine{transfer.seed, number_index};
+                    server::draw(sampler, engine);
+
+                    uint32_t retry_index{0};
+                    do {
+                        number = server::draw(sampler, engine);
+                        ++retry_index;
+                    } while (!transfer.sent_numbers
+                                  .insert(utils::get_bit_pattern(number))
+                                  .second);
+
+                    std::lock_guard lock{transfer.regeneration_mutex};
+                    transfer.redraws.emplace(number_index, retry_index);
+                }
+            },
+            std::get<Samplers<NumberType>>(transfer.sampler));
+    }
+
+    // Replays the draws of a sequence already generated, the numbers it
+    // added to sent_numbers are left as they are
+    template <typename Traits>
+    void readd_random_numbers(Transfer &transfer,
+                              NumberSequenceResponse &response) {
+        using NumberType = typename Traits::value_type;
+
+        auto &numbers = *Traits::mutable_numbers(response);
+        std::lock_guard lock{transfer.regeneration_mutex};
+
+        if constexpr (std::integral<NumberType>) {
+            if (transfer.range_shuffle) {
+                const auto lower_bound =
+                    get_bounds<NumberType>(transfer.request).first;
+
+                for (const auto number_index : get_number_indices(
+                         transfer, response.sequence_index(),
+                         response.sequence_number_count())) {
+                    numbers.Add(get_shuffled_number(
+                        lower_bound,
+                        transfer.range_shuffle->get(number_index)));
+                }
+
+                return;
             }
+        }
 
-            if (client_numbers.contains(number)) {
-                throw std::runtime_error{
-                    std::format("Failed to generate unique number. "
-                                "Maximum retries exceeded")};
+        std::visit(
+            [&](const auto &sampler) {
+                for (const auto number_index : get_number_indices(
+                         transfer, response.sequence_index(),
+                         response.sequence_number_count())) {
+                    server::CounterEngine engine{transfer.seed, number_index};
+                    auto number = server::draw(sampler, engine);
+
+                    if (const auto redraw = transfer.redraws.find(number_index);
+                        redraw != transfer.redraws.end()) {
+                        for (uint32_t retry_index{0};
+                             retry_index < redraw->second; ++retry_index) {
+                            number = server::draw(sampler, engine);
+                        }
+                    }
+
+                    numbers.Add(number);
+                }
+            },
+            std::get<Samplers<NumberType>>(transfer.sampler));
+    }
+
+    // Sequences are generated one after another, so the generator continues
+    // where the previous sequence stopped and the numbers of all sequences
+    // form a single descending sample. A regenerated sequence starts from the
+    // copy of the generator taken before it.
+    template <typename Traits>
+    void add_descending_numbers(Transfer &transfer,
+                                NumberSequenceResponse &response,
+                                bool regenerate) {
+        using NumberType = typename Traits::value_type;
+        using Generator = server::DescendingUniformGenerator<NumberType>;
+
+        auto number_count = response.sequence_number_count();
+        auto &numbers = *Traits::mutable_numbers(response);
+
+        std::optional<Generator> checkpoint;
+        {
+            std::lock_guard lock{transfer.regeneration_mutex};
+            if (regenerate) {
+                checkpoint = std::get<Generator>(
+                    transfer.checkpoints.at(response.sequence_index()));
             } else {
-                response.mutable_numbers()->Add(number);
-                client_numbers.insert(number);
+                transfer.checkpoints.insert_or_assign(
+                    response.sequence_index(), transfer.descending_generator);
             }
         }
+
+        auto &generator =
+            checkpoint ? *checkpoint
+                       : std::get<Generator>(transfer.descending_generator);
+
+        while (number_count--) {
+            numbers.Add(generator());
+        }
     }
 
-    void init_sender(uint64_t number_count) {
-        auto &numbers = senders_[sender_endpoint_];
-        numbers.reserve(number_count);
+    template <std::integral NumberType>
+    static NumberType get_shuffled_number(NumberType lower_bound,
+                                          uint64_t offset) {
+        return static_cast<NumberType>(static_cast<uint64_t>(lower_bound) +
+                                       offset);
+    }
+
+    void release_number_sequence(Transfer &transfer, uint64_t sequence_index) {
+        std::lock_guard lock{transfer.regeneration_mutex};
+        transfer.checkpoints.erase(sequence_index);
+
+        if (transfer.range_shuffle) {
+            for (const auto number_index :
+                 get_number_indices(transfer, sequence_index,
+                                    transfer.sequence_max_number_count)) {
+                transfer.range_shuffle->release(number_index);
+            }
+        }
+
+        if (!transfer.redraws.empty()) {
+            for (const auto number_index :
+                 get_number_indices(transfer, sequence_index,
+                                    transfer.sequence_max_number_count)) {
+                transfer.redraws.erase(number_index);
+            }
+        }
     }
 
-    void free_sender() { senders_.erase(sender_endpoint_); }
+    // Numbers are indexed across the whole transfer
+    static auto get_number_indices(const Transfer &transfer,
+                                   uint64_t sequence_index,
+                                   uint64_t number_count) {
+        const auto first_number_index =
+            sequence_index * transfer.sequence_max_number_count;
+
+        return std::views::iota(first_number_index,
+                                first_number_index + number_count);
+    }
+
+    // Streams are published through the server socket, so repairs and
+    // published sequences share its source address
+    void enable_multicast(const server::Config &config) {
+        namespace multicast = boost::asio::ip::multicast;
+
+        multicast_endpoint_ = udp::endpoint{
+            boost::asio::ip::make_address_v4(config.multicast_group()),
+            config.multicast_port()};
+        multicast_interval_ =
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::seconds{1}) /
+            config.multicast_rate();
+
+        socket_.set_option(multicast::hops(config.multicast_ttl()));
+        socket_.set_option(multicast::enable_loopback(true));
+
+        if (!config.multicast_interface().empty()) {
+            socket_.set_option(multicast::outbound_interface(
+                boost::asio::ip::make_address_v4(
+                    config.multicast_interface())));
+        }
+    }
+
+    static utils::RttEstimator create_rtt_estimator() {
+        return utils::RttEstimator{INITIAL_RETRANSMISSION_TIMEOUT,
+                                   MIN_RETRANSMISSION_TIMEOUT,
+                                   MAX_RETRANSMISSION_TIMEOUT};
+    }
 
 private:
-    static constexpr uint32_t PROTOCOL_VERSION{1};
+    static constexpr uint32_t PROTOCOL_VERSION{3};
 
-    boost::asio::io_context &io_context_;
+    boost::asio::io_context &generator_context_;
+    boost::asio::strand<boost::asio::io_context::executor_type> strand_;
     udp_socket socket_;
     udp::endpoint sender_endpoint_;
     std::string buffer_;
+    const server::Config &config_;
     utils::Logger &logger_;
-    std::unordered_map<udp::endpoint, std::unordered_set<NumberType>> senders_;
+    server::CookieGenerator cookie_generator_;
+    std::mt19937_64 seed_generator_;
+    std::unordered_map<uint64_t, std::shared_ptr<Session>> sessions_;
+    // Unset port when multicast is disabled
+    udp::endpoint multicast_endpoint_;
+    std::chrono::steady_clock::duration multicast_interval_{};
+    std::unordered_map<uint64_t, std::shared_ptr<Stream>> streams_;
+    uint64_t next_stream_id_{1};
+    // Numbers of the admitted transfers and streams not yet finished
+    uint64_t numbers_in_flight_{0};
+    std::set<QueuedRequest> admission_queue_;
+    // Wakes up at the earliest queue deadline
+    steady_timer admission_timer_;
+    uint64_t next_arrival_index_{0};
+    std::unordered_map<boost::asio::ip::address, server::TokenBucket>
+        client_buckets_;
+    // Set when shared memory is enabled, the rings are waited on by their
+    // own threads. Declared last, so that its threads are joined first.
+    std::optional<boost::asio::thread_pool> shared_memory_waiter_;
 };
 
 int main(int argc, char *argv[]) {
@@ -326,31 +2081,71 @@ int main(int argc, char *argv[]) {
         command_line_options.parse(argc, argv);
         server::Config config{command_line_options.config_path()};
         utils::Logger logger{command_line_options.logs_path()};
+        server::ThreadTopology topology{config};
 
         boost::asio::io_context io_context;
+        boost::asio::io_context generator_context;
         auto work = boost::asio::make_work_guard(io_context);
+        auto generator_work = boost::asio::make_work_guard(generator_context);
         boost::asio::signal_set signals{io_context, SIGINT, SIGTERM};
         signals.async_wait([&](auto, auto) {
             io_context.stop();
+            generator_context.stop();
             work.reset();
+            generator_work.reset();
         });
 
-        logger.log("Starting server on port: {}", config.port());
-        UDPRandomGeneratorServer server{io_context, config, logger};
+        logger.log("Starting server on port: {} with {} I/O backend",
+                   config.port(), utils::IO_BACKEND);
+        UDPRandomGeneratorServer server{io_context, generator_context, config,
+                                        logger};
         server.start();
 
-        std::size_t thread_count = std::thread::hardware_concurrency();
-        std::vector<std::jthread> threads;
-        threads.reserve(thread_count);
+        logger.log("Launching {} I/O threads on CPUs {} and {} generator "
+                   "threads on CPUs {}. NUMA node: {}",
+                   topology.io_thread_count(),
+                   server::ThreadTopology::format_cpu_list(topology.io_cpus()),
+                   topology.generator_thread_count(),
+                   server::ThreadTopology::format_cpu_list(
+                       topology.generator_cpus()),
+                   topology.numa_node() ? std::to_string(*topology.numa_node())
+                                        : std::string{"any"});
+
+        const auto run_thread = [&](boost::asio::io_context &context,
+                                    bool applied, std::string_view role,
+                                    uint32_t thread_index) {
+            if (!applied) {
+                logger.log("Failed to apply thread placement to {} thread {}",
+                           role, thread_index);
+            }
+
+            context.run();
+        };
 
-        logger.log("Launching {} threads", thread_count);
+        std::vector<std::jthread> threads;
+        threads.reserve(topology.io_thread_count() - 1 +
+                        topology.generator_thread_count());
+
+        for (uint32_t thread_index{0};
+             thread_index < topology.generator_thread_count(); ++thread_index) {
+            threads.emplace_back([&, thread_index] {
+                run_thread(generator_context,
+                           topology.apply_to_generator_thread(thread_index),
+                           "generator", thread_index);
+            });
+        }
 
-        for (std::size_t thread_index{0}; thread_index < thread_count;
-             ++thread_index) {
-            threads.emplace_back([&] { io_context.run(); });
+        // The main thread is the first I/O thread
+        for (uint32_t thread_index{1};
+             thread_index < topology.io_thread_count(); ++thread_index) {
+            threads.emplace_back([&, thread_index] {
+                run_thread(io_context,
+                           topology.apply_to_io_thread(thread_index), "I/O",
+                           thread_index);
+            });
         }
 
-        io_context.run();
+        run_thread(io_context, topology.apply_to_io_thread(0), "I/O", 0);
     } catch (std::exception &error) {
         utils::println(std::cerr, "Exception: {}\n", error.what());
         return 1;
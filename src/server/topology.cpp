@@ -0,0 +1,258 @@
+#include "server/topology.hpp"
+#include "constants.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+using namespace server;
+
+namespace {
+
+struct InterfaceLayout {
+    std::vector<uint32_t> irq_cpus;
+    std::vector<uint32_t> local_cpus;
+    std::optional<uint32_t> numa_node;
+    uint32_t irq_count{};
+};
+
+std::string read_first_line(const std::filesystem::path &path) {
+    std::ifstream file{path};
+    std::string line;
+    std::getline(file, line);
+
+    return line;
+}
+
+// Reads the interrupt affinity and NUMA locality of a network interface from
+// sysfs and procfs. Returns an empty layout when the information is not
+// available.
+InterfaceLayout read_interface_layout(const std::string &interface) {
+    InterfaceLayout layout;
+
+#if defined(__linux__)
+    if (interface.empty()) {
+        return layout;
+    }
+
+    const auto device_path =
+        std::filesystem::path{"/sys/class/net"} / interface / "device";
+    if (!std::filesystem::exists(device_path)) {
+        return layout;
+    }
+
+    layout.local_cpus = ThreadTopology::parse_cpu_list(
+        read_first_line(device_path / "local_cpulist"));
+
+    const auto numa_node = read_first_line(device_path / "numa_node");
+    int node{-1};
+    std::from_chars(numa_node.data(), numa_node.data() + numa_node.size(),
+                    node);
+    if (node >= 0) {
+        layout.numa_node = static_cast<uint32_t>(node);
+    }
+
+    std::error_code error;
+    for (const auto &irq :
+         std::filesystem::directory_iterator{device_path / "msi_irqs", error}) {
+        const auto irq_cpus = ThreadTopology::parse_cpu_list(
+            read_first_line(std::filesystem::path{"/proc/irq"} /
+                            irq.path().filename() / "smp_affinity_list"));
+
+        layout.irq_cpus.insert(layout.irq_cpus.end(), irq_cpus.begin(),
+                               irq_cpus.end());
+        ++layout.irq_count;
+    }
+
+    std::ranges::sort(layout.irq_cpus);
+    const auto duplicates = std::ranges::unique(layout.irq_cpus);
+    layout.irq_cpus.erase(duplicates.begin(), duplicates.end());
+#endif
+
+    return layout;
+}
+
+} // namespace
+
+ThreadTopology::ThreadTopology(const Config &config)
+    : io_cpus_{config.io_cpus()}, generator_cpus_{config.generator_cpus()},
+      numa_node_{config.numa_node()} {
+    const auto layout = read_interface_layout(config.network_interface());
+
+    if (!numa_node_) {
+        numa_node_ = layout.numa_node;
+    }
+
+    if (io_cpus_.empty()) {
+        io_cpus_ = layout.irq_cpus;
+    }
+
+    if (generator_cpus_.empty()) {
+        std::ranges::copy_if(
+            layout.local_cpus, std::back_inserter(generator_cpus_),
+            [this](uint32_t cpu) {
+                return std::ranges::find(io_cpus_, cpu) == io_cpus_.end();
+            });
+    }
+
+    // Without an interrupt layout every I/O thread would land on an
+    // arbitrary core, so a single one is used by default
+    uint32_t default_io_thread_count{1};
+    if (!io_cpus_.empty()) {
+        default_io_thread_count = static_cast<uint32_t>(io_cpus_.size());
+        if (layout.irq_count != 0) {
+            default_io_thread_count =
+                std::min(default_io_thread_count, layout.irq_count);
+        }
+    }
+
+    io_thread_count_ =
+        std::max(config.io_thread_count().value_or(default_io_thread_count),
+                 uint32_t{1});
+
+    const uint32_t hardware_thread_count =
+        std::max(std::thread::hardware_concurrency(), 1u);
+    const uint32_t default_generator_thread_count =
+        generator_cpus_.empty()
+            ? std::max(hardware_thread_count - std::min(hardware_thread_count,
+                                                        io_thread_count_),
+                       1u)
+            : static_cast<uint32_t>(generator_cpus_.size());
+
+    generator_thread_count_ =
+        std::max(config.generator_thread_count().value_or(
+                     default_generator_thread_count),
+                 uint32_t{1});
+}
+
+bool ThreadTopology::apply_to_io_thread(uint32_t thread_index) const {
+    return apply_to_thread(io_cpus_, thread_index);
+}
+
+bool ThreadTopology::apply_to_generator_thread(uint32_t thread_index) const {
+    return apply_to_thread(generator_cpus_, thread_index);
+}
+
+bool ThreadTopology::apply_to_thread(const std::vector<uint32_t> &cpus,
+                                     uint32_t thread_index) const {
+    bool applied{true};
+
+#if defined(__linux__)
+    if (!cpus.empty()) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(cpus[thread_index % cpus.size()], &cpu_set);
+
+        applied &= (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set),
+                                           &cpu_set) == 0);
+    }
+
+    // Memory first touched by the thread, such as session buffers, is
+    // allocated on the preferred node
+    if (numa_node_) {
+        unsigned long node_mask{0};
+        constexpr uint32_t node_mask_bit_count{sizeof(node_mask) * CHAR_BIT};
+
+        if (*numa_node_ < node_mask_bit_count) {
+            node_mask = 1UL << *numa_node_;
+            applied &= (syscall(SYS_set_mempolicy, MPOL_PREFERRED, &node_mask,
+                                node_mask_bit_count + 1) == 0);
+        } else {
+            applied = false;
+        }
+    }
+#elif defined(_WIN32)
+    if (!cpus.empty()) {
+        const auto cpu = cpus[thread_index % cpus.size()];
+        applied &= (cpu < 64) && (SetThreadAffinityMask(GetCurrentThread(),
+                                                        DWORD_PTR{1} << cpu) !=
+                                  0);
+    }
+
+    applied &= !numa_node_;
+#else
+    applied = cpus.empty() && !numa_node_;
+#endif
+
+    return applied;
+}
+
+std::vector<uint32_t>
+ThreadTopology::parse_cpu_list(std::string_view cpu_list) {
+    std::vector<uint32_t> cpus;
+
+    // A separator is always followed by a range, even at the end
+    for (bool has_range{!cpu_list.empty()}; has_range;) {
+        const auto separator = cpu_list.find(',');
+        const auto range = cpu_list.substr(0, separator);
+        has_range = (separator != std::string_view::npos);
+        cpu_list.remove_prefix(has_range ? separator + 1 : cpu_list.size());
+
+        const auto *range_end = range.data() + range.size();
+        uint32_t first{};
+        auto [parse_end, parse_error] =
+            std::from_chars(range.data(), range_end, first);
+
+        uint32_t last{first};
+        if (parse_error == std::errc{} && parse_end != range_end &&
+            *parse_end == '-') {
+            const auto [last_end, last_error] =
+                std::from_chars(parse_end + 1, range_end, last);
+            parse_end = last_end;
+            parse_error = last_error;
+        }
+
+        if (parse_error != std::errc{} || parse_end != range_end ||
+            first > last || last >= MAX_CPU_COUNT) {
+            throw std::runtime_error{std::format(
+                "Invalid CPU range \"{}\" in CPU list. CPUs must be less "
+                "than {}",
+                range, MAX_CPU_COUNT)};
+        }
+
+        for (uint32_t cpu{first}; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+
+    return cpus;
+}
+
+std::string
+ThreadTopology::format_cpu_list(const std::vector<uint32_t> &cpus) {
+    std::string cpu_list;
+
+    for (size_t index{0}; index < cpus.size();) {
+        size_t last_index{index};
+        while (last_index + 1 < cpus.size() &&
+               cpus[last_index + 1] == cpus[last_index] + 1) {
+            ++last_index;
+        }
+
+        if (!cpu_list.empty()) {
+            cpu_list += ',';
+        }
+
+        cpu_list += (last_index == index)
+                        ? std::format("{}", cpus[index])
+                        : std::format("{}-{}", cpus[index], cpus[last_index]);
+        index = last_index + 1;
+    }
+
+    return cpu_list.empty() ? "any" : cpu_list;
+}
@@ -0,0 +1,156 @@
+#include "protocol.pb.h"
+#include "utils/element_type.hpp"
+#include "utils/logger.hpp"
+#include "verify/checks.hpp"
+#include "verify/mapped_file.hpp"
+#include "verify/options.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+
+namespace {
+
+// Bounds beyond the type are clamped to it before the conversion, which
+// is undefined for values out of its range
+template <typename NumberType> NumberType to_number_bound(double bound) {
+    using Limits = std::numeric_limits<NumberType>;
+
+    // The first value out of range, 2^digits for integers
+    const auto max_bound = std::integral<NumberType>
+                               ? std::ldexp(1.0, Limits::digits)
+                               : static_cast<double>(Limits::max());
+
+    if (!(bound < max_bound)) {
+        return Limits::max();
+    }
+
+    if (bound <= static_cast<double>(Limits::lowest())) {
+        return Limits::lowest();
+    }
+
+    return static_cast<NumberType>(bound);
+}
+
+// Bounds as the server applies them, integer bounds are rounded towards the
+// inside of the range
+template <typename NumberType>
+std::pair<NumberType, NumberType> get_bounds(double lower_bound,
+                                             double upper_bound) {
+    if constexpr (std::integral<NumberType>) {
+        return {to_number_bound<NumberType>(std::ceil(lower_bound)),
+                to_number_bound<NumberType>(std::floor(upper_bound))};
+    } else {
+        return {to_number_bound<NumberType>(lower_bound),
+                to_number_bound<NumberType>(upper_bound)};
+    }
+}
+
+std::string format_violation(uint64_t violation_count,
+                             std::optional<size_t> first_violation) {
+    if (violation_count == 0) {
+        return "yes";
+    }
+
+    return std::format("no, {} violations, the first at index {}",
+                       violation_count, *first_violation);
+}
+
+// A numbers file holds the count of numbers followed by the numbers
+template <typename Traits>
+bool verify_numbers_file(const verify::MappedFile &numbers_file,
+                         std::optional<double> lower_bound,
+                         std::optional<double> upper_bound) {
+    using NumberType = typename Traits::value_type;
+
+    const auto bytes = numbers_file.bytes();
+    if (bytes.size() < sizeof(size_t)) {
+        utils::println("Numbers file is too short to hold the count: {} "
+                       "bytes",
+                       bytes.size());
+        return false;
+    }
+
+    size_t header_count{};
+    std::memcpy(&header_count, bytes.data(), sizeof(header_count));
+
+    const auto number_bytes = bytes.subspan(sizeof(size_t));
+    const std::span numbers{
+        reinterpret_cast<const NumberType *>(number_bytes.data()),
+        number_bytes.size() / sizeof(NumberType)};
+
+    const bool count_matches =
+        header_count == numbers.size() &&
+        number_bytes.size() % sizeof(NumberType) == 0;
+
+    // Without bounds only NaN and infinities are out of range
+    const auto [lower_number, upper_number] = get_bounds<NumberType>(
+        lower_bound.value_or(std::numeric_limits<double>::lowest()),
+        upper_bound.value_or(std::numeric_limits<double>::max()));
+
+    const auto start_time = std::chrono::steady_clock::now();
+    const auto result =
+        verify::check_numbers(numbers, lower_number, upper_number);
+    const std::chrono::duration<double> elapsed{
+        std::chrono::steady_clock::now() - start_time};
+
+    utils::println("Element type: {}", Traits::name);
+    utils::println("Numbers: {}. Header count: {}{}", numbers.size(),
+                   header_count, count_matches ? "" : ", mismatch");
+    utils::println("Strictly descending: {}",
+                   format_violation(result.order_violation_count,
+                                    result.first_order_violation));
+
+    if (lower_bound || upper_bound) {
+        utils::println("Within [{}, {}]: {}", lower_number, upper_number,
+                       format_violation(result.bound_violation_count,
+                                        result.first_bound_violation));
+    } else if constexpr (std::floating_point<NumberType>) {
+        utils::println("Finite: {}",
+                       format_violation(result.bound_violation_count,
+                                        result.first_bound_violation));
+    }
+
+    utils::println("Checksum: {}", result.checksum);
+    utils::println("Checked {} bytes in {:.3f} s ({:.2f} GB/s)",
+                   number_bytes.size(), elapsed.count(),
+                   static_cast<double>(number_bytes.size()) / 1e9 /
+                       std::max(elapsed.count(), 1e-9));
+
+    return count_matches && result.order_violation_count == 0 &&
+           result.bound_violation_count == 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    try {
+        verify::CommandLineOptions command_line_options;
+        command_line_options.parse(argc, argv);
+
+        const verify::MappedFile numbers_file{
+            command_line_options.numbers_path()};
+
+        const bool valid = utils::visit_element_type(
+            utils::parse_element_type(command_line_options.element_type()),
+            [&]<typename Traits>(Traits) {
+                return verify_numbers_file<Traits>(
+                    numbers_file, command_line_options.lower_bound(),
+                    command_line_options.upper_bound());
+            });
+
+        utils::println("Numbers file is {}", valid ? "valid" : "invalid");
+        return valid ? 0 : 1;
+    } catch (std::exception &error) {
+        utils::println(std::cerr, "Exception: {}", error.what());
+        return 2;
+    }
+}
@@ -0,0 +1,81 @@
+#include "verify/mapped_file.hpp"
+
+#include <format>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace verify;
+
+MappedFile::MappedFile(const std::filesystem::path &path)
+    : size_{static_cast<size_t>(std::filesystem::file_size(path))} {
+    // Empty files cannot be mapped and have nothing to check
+    if (size_ == 0) {
+        return;
+    }
+
+#if defined(_WIN32)
+    file_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+        file_ = nullptr;
+        throw std::runtime_error{
+            std::format("Failed to open file. Path: {}", path.string())};
+    }
+
+    mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping_) {
+        CloseHandle(file_);
+        throw std::runtime_error{
+            std::format("Failed to map file. Path: {}", path.string())};
+    }
+
+    data_ = static_cast<const std::byte *>(
+        MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (!data_) {
+        CloseHandle(mapping_);
+        CloseHandle(file_);
+        throw std::runtime_error{
+            std::format("Failed to map file. Path: {}", path.string())};
+    }
+#else
+    const auto file = open(path.c_str(), O_RDONLY);
+    if (file == -1) {
+        throw std::runtime_error{
+            std::format("Failed to open file. Path: {}", path.string())};
+    }
+
+    // The mapping stays valid once the descriptor is closed
+    auto *mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error{
+            std::format("Failed to map file. Path: {}", path.string())};
+    }
+
+    // Every thread scans its part of the file front to back
+    madvise(mapping, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const std::byte *>(mapping);
+#endif
+}
+
+MappedFile::~MappedFile() {
+    if (!data_) {
+        return;
+    }
+
+#if defined(_WIN32)
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_);
+    CloseHandle(file_);
+#else
+    munmap(const_cast<std::byte *>(data_), size_);
+#endif
+}
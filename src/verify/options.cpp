@@ -0,0 +1,42 @@
+#include "verify/options.hpp"
+
+#include <boost/program_options.hpp>
+
+using namespace verify;
+
+CommandLineOptions::CommandLineOptions() : description_{"Options"} {
+    namespace po = boost::program_options;
+
+    description_.add_options()(
+        "numbers-path",
+        po::value<std::filesystem::path>(&numbers_path_)->required(),
+        "File with numbers location");
+    description_.add_options()(
+        "element-type",
+        po::value<std::string>(&element_type_)->default_value("float64"),
+        "Type of the numbers: float64, float32, int32 or int64");
+    description_.add_options()(
+        "upper-bound", po::value<double>(),
+        "Numbers must lie within [lower-bound, upper-bound]");
+    description_.add_options()(
+        "lower-bound", po::value<double>(),
+        "Lowest number allowed, -upper-bound by default");
+}
+
+void CommandLineOptions::parse(int argc, char *argv[]) {
+    namespace po = boost::program_options;
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, description_), vm);
+    po::notify(vm);
+
+    if (vm.count("upper-bound") != 0) {
+        upper_bound_ = vm["upper-bound"].as<double>();
+    }
+
+    if (vm.count("lower-bound") != 0) {
+        lower_bound_ = vm["lower-bound"].as<double>();
+    } else if (upper_bound_) {
+        lower_bound_ = -*upper_bound_;
+    }
+}
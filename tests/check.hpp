@@ -0,0 +1,39 @@
+#pragma once
+
+#include <iostream>
+#include <source_location>
+
+namespace tests {
+
+inline int failure_count{0};
+
+// Unlike assert, stays active in release builds. A failed check is reported
+// with its location and fails the test once it ends.
+inline void check(bool condition, const std::source_location location =
+                                      std::source_location::current()) {
+    if (!condition) {
+        std::cerr << location.file_name() << ':' << location.line()
+                  << ": check failed\n";
+        ++failure_count;
+    }
+}
+
+template <typename Function>
+void check_throws(const Function &function,
+                  const std::source_location location =
+                      std::source_location::current()) {
+    bool thrown{false};
+
+    try {
+        function();
+    } catch (...) {
+        thrown = true;
+    }
+
+    check(thrown, location);
+}
+
+// The exit code of a test
+inline int result() { return (failure_count == 0) ? 0 : 1; }
+
+} // namespace tests
@@ -0,0 +1,99 @@
+#include "check.hpp"
+#include "utils/radix_sort.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace {
+
+template <typename NumberType>
+std::vector<NumberType> sort_descending(std::vector<NumberType> numbers) {
+    utils::radix_sort_descending(std::span{numbers});
+    return numbers;
+}
+
+// Negative numbers sort below positive ones for both signed integers and
+// floating-point numbers
+void test_sign_flip() {
+    tests::check(sort_descending<int32_t>({-1, 2, -3, 0, 1}) ==
+                 std::vector<int32_t>{2, 1, 0, -1, -3});
+    tests::check(sort_descending<double>({-0.5, 2.5, -3.0, 1.0}) ==
+                 std::vector<double>{2.5, 1.0, -0.5, -3.0});
+    tests::check(sort_descending<float>({-1.0f, -2.0f, 3.0f}) ==
+                 std::vector<float>{3.0f, -1.0f, -2.0f});
+}
+
+// Numbers are ordered by their bit patterns: +0.0 before -0.0, positive NaN
+// above infinity and negative NaN below minus infinity. The bits come back
+// unchanged.
+void test_signed_zeros_and_nans() {
+    constexpr auto infinity = std::numeric_limits<double>::infinity();
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+
+    const auto numbers = sort_descending<double>(
+        {-0.0, 1.0, -nan, 0.0, -infinity, nan, infinity, -1.0});
+
+    tests::check(std::isnan(numbers[0]) && !std::signbit(numbers[0]));
+    tests::check(numbers[1] == infinity);
+    tests::check(numbers[2] == 1.0);
+    tests::check(numbers[3] == 0.0 && !std::signbit(numbers[3]));
+    tests::check(numbers[4] == 0.0 && std::signbit(numbers[4]));
+    tests::check(numbers[5] == -1.0);
+    tests::check(numbers[6] == -infinity);
+    tests::check(std::isnan(numbers[7]) && std::signbit(numbers[7]));
+    tests::check(std::bit_cast<uint64_t>(numbers[0]) ==
+                 std::bit_cast<uint64_t>(nan));
+}
+
+void test_int64_extremes() {
+    constexpr auto min = std::numeric_limits<int64_t>::min();
+    constexpr auto max = std::numeric_limits<int64_t>::max();
+
+    tests::check(sort_descending<int64_t>({0, min, -1, max, 1, min + 1}) ==
+                 std::vector<int64_t>{max, 1, 0, -1, min + 1, min});
+}
+
+// Keys sharing all but their lowest digit sort in one pass, equal keys in
+// none, so the sorted keys are found in either buffer
+void test_skipped_passes() {
+    tests::check(sort_descending<int32_t>({5, 1, 7, 3}) ==
+                 std::vector<int32_t>{7, 5, 3, 1});
+    tests::check(sort_descending<int64_t>({9, 9, 9}) ==
+                 std::vector<int64_t>{9, 9, 9});
+    tests::check(sort_descending<int64_t>({int64_t{1} << 40, 3,
+                                           (int64_t{1} << 40) + 3, 0}) ==
+                 std::vector<int64_t>{(int64_t{1} << 40) + 3,
+                                      int64_t{1} << 40, 3, 0});
+}
+
+// Large enough to be split into chunks on machines with several threads
+void test_random_numbers() {
+    std::mt19937_64 engine{7};
+    std::uniform_real_distribution<double> distribution{-1e6, 1e6};
+    std::vector<double> numbers(utils::radix::MIN_CHUNK_SIZE * 4 + 3);
+    std::ranges::generate(numbers, [&] { return distribution(engine); });
+
+    auto expected = numbers;
+    std::ranges::sort(expected, std::greater{});
+
+    tests::check(sort_descending(std::move(numbers)) == expected);
+}
+
+} // namespace
+
+int main() {
+    test_sign_flip();
+    test_signed_zeros_and_nans();
+    test_int64_extremes();
+    test_skipped_passes();
+    test_random_numbers();
+
+    return tests::result();
+}
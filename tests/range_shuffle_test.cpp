@@ -0,0 +1,66 @@
+#include "check.hpp"
+#include "server/range_shuffle.hpp"
+
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+// Drawing the whole range yields every offset once, and the offsets drawn
+// are read back unchanged
+void test_whole_range() {
+    constexpr uint64_t range{1000};
+    server::RangeShuffle shuffle{range, 17};
+    std::vector<uint64_t> offsets;
+    std::unordered_set<uint64_t> values;
+
+    for (uint64_t index{0}; index < range; ++index) {
+        offsets.push_back(shuffle());
+        values.insert(offsets.back());
+        tests::check(offsets.back() < range);
+    }
+
+    tests::check(values.size() == range);
+    tests::check(shuffle.drawn_count() == range);
+
+    for (uint64_t index{0}; index < range; ++index) {
+        tests::check(shuffle.get(index) == offsets[index]);
+    }
+}
+
+// Numbers released once acknowledged do not disturb the later draws
+void test_release() {
+    server::RangeShuffle shuffle{64, 4};
+    server::RangeShuffle released_shuffle{64, 4};
+    std::unordered_set<uint64_t> values;
+
+    for (uint64_t index{0}; index < 64; ++index) {
+        const auto offset = shuffle();
+        tests::check(released_shuffle() == offset);
+        released_shuffle.release(index);
+        values.insert(offset);
+    }
+
+    tests::check(values.size() == 64);
+}
+
+// The same seed draws the same offsets
+void test_seed() {
+    server::RangeShuffle shuffle{1 << 20, 8};
+    server::RangeShuffle other_shuffle{1 << 20, 8};
+
+    for (uint32_t index{0}; index < 100; ++index) {
+        tests::check(shuffle() == other_shuffle());
+    }
+}
+
+} // namespace
+
+int main() {
+    test_whole_range();
+    test_release();
+    test_seed();
+
+    return tests::result();
+}
@@ -0,0 +1,83 @@
+#include "check.hpp"
+#include "server/philox.hpp"
+#include "server/samplers.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+// A range of zero stands for all 2^64 values: every word is accepted and
+// maps onto the lower bound plus the word
+void test_uniform_full_range() {
+    constexpr auto min = std::numeric_limits<int64_t>::min();
+    constexpr auto max = std::numeric_limits<int64_t>::max();
+    const server::UniformSampler<int64_t> sampler{min, max};
+
+    for (const uint64_t word :
+         {uint64_t{0}, uint64_t{1}, uint64_t{1} << 63,
+          std::numeric_limits<uint64_t>::max()}) {
+        int64_t number{};
+        tests::check(sampler.transform(word, 0, number));
+        tests::check(number == static_cast<int64_t>(
+                                   static_cast<uint64_t>(min) + word));
+    }
+
+    int64_t number{};
+    sampler.transform(std::numeric_limits<uint64_t>::max(), 0, number);
+    tests::check(number == max);
+    tests::check(sampler.max_probability() > 0);
+}
+
+// The widest range short of the full one, where the rejection threshold is
+// largest
+void test_uniform_wide_range() {
+    const server::UniformSampler<int64_t> sampler{
+        std::numeric_limits<int64_t>::min() + 1,
+        std::numeric_limits<int64_t>::max()};
+
+    for (uint64_t number_index{0}; number_index < 1000; ++number_index) {
+        server::CounterEngine engine{3, number_index};
+        const auto number = server::draw(sampler, engine);
+        tests::check(number > std::numeric_limits<int64_t>::min());
+    }
+}
+
+// Every value of a small range is drawn, and nothing outside of it
+void test_uniform_small_range() {
+    const server::UniformSampler<int32_t> sampler{-3, 3};
+    std::vector<int32_t> numbers(1000);
+    server::sample_batch(sampler, std::span{numbers}, 5, 0);
+
+    const std::unordered_set<int32_t> values{numbers.begin(), numbers.end()};
+    tests::check(values.size() == 7);
+    for (const auto value : values) {
+        tests::check(value >= -3 && value <= 3);
+    }
+}
+
+// A batch holds the first draw of every stream
+void test_batch_matches_draws() {
+    const server::NormalSampler<double> sampler{-10.0, 10.0};
+    std::vector<double> numbers(600);
+    server::sample_batch(sampler, std::span{numbers}, 9, 100);
+
+    for (uint64_t index{0}; index < numbers.size(); ++index) {
+        server::CounterEngine engine{9, 100 + index};
+        tests::check(numbers[index] == server::draw(sampler, engine));
+    }
+}
+
+} // namespace
+
+int main() {
+    test_uniform_full_range();
+    test_uniform_wide_range();
+    test_uniform_small_range();
+    test_batch_matches_draws();
+
+    return tests::result();
+}
@@ -0,0 +1,63 @@
+#include "check.hpp"
+#include "client/split.hpp"
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+uint64_t sum(const std::vector<uint64_t> &counts) {
+    return std::accumulate(counts.begin(), counts.end(), uint64_t{0});
+}
+
+void test_proportional_split() {
+    tests::check(client::split_number_count(10, {50, 50}) ==
+                 std::vector<uint64_t>{5, 5});
+    tests::check(client::split_number_count(12, {100, 200, 300}) ==
+                 std::vector<uint64_t>{2, 4, 6});
+}
+
+// The rounding remainder goes to the first sub-intervals with room left
+void test_rounding_remainder() {
+    tests::check(client::split_number_count(10, {5, 5, 5}) ==
+                 std::vector<uint64_t>{4, 3, 3});
+    tests::check(client::split_number_count(10, {3, 5, 5}) ==
+                 std::vector<uint64_t>{3, 4, 3});
+}
+
+// A full range takes every capacity, empty sub-intervals get nothing
+void test_capacities() {
+    tests::check(client::split_number_count(7, {3, 4}) ==
+                 std::vector<uint64_t>{3, 4});
+    tests::check(client::split_number_count(4, {0, 10, 0}) ==
+                 std::vector<uint64_t>{0, 4, 0});
+}
+
+// The servers reject counts beyond the capacities, the excess is kept
+void test_excess() {
+    tests::check(client::split_number_count(10, {3, 3, 3}) ==
+                 std::vector<uint64_t>{4, 3, 3});
+    tests::check(client::split_number_count(3, {0, 0}) ==
+                 std::vector<uint64_t>{3, 0});
+}
+
+// Capacities of floating-point sub-intervals are the server weights
+void test_weights() {
+    const auto counts = client::split_number_count(1'000'001, {1.0, 2.0});
+
+    tests::check(sum(counts) == 1'000'001);
+    tests::check(counts[0] == 333'333 + 1 && counts[1] == 666'667);
+}
+
+} // namespace
+
+int main() {
+    test_proportional_split();
+    test_rounding_remainder();
+    test_capacities();
+    test_excess();
+    test_weights();
+
+    return tests::result();
+}
@@ -0,0 +1,58 @@
+#include "check.hpp"
+#include "constants.hpp"
+#include "server/topology.hpp"
+
+#include <cstdint>
+#include <format>
+#include <vector>
+
+using server::ThreadTopology;
+
+namespace {
+
+// Lists as found in sysfs
+void test_parse_cpu_list() {
+    tests::check(ThreadTopology::parse_cpu_list("0-3,8") ==
+                 std::vector<uint32_t>{0, 1, 2, 3, 8});
+    tests::check(ThreadTopology::parse_cpu_list("5") ==
+                 std::vector<uint32_t>{5});
+    tests::check(ThreadTopology::parse_cpu_list("2-2,7-8") ==
+                 std::vector<uint32_t>{2, 7, 8});
+    tests::check(ThreadTopology::parse_cpu_list("").empty());
+    tests::check(
+        ThreadTopology::parse_cpu_list(std::format("{}", MAX_CPU_COUNT - 1)) ==
+        std::vector<uint32_t>{MAX_CPU_COUNT - 1});
+}
+
+void test_invalid_cpu_lists() {
+    for (const auto *cpu_list :
+         {"a", "1,", ",1", "3-1", "0-", "-3", "1-2-3", "1 ", "0x1", "4,5a"}) {
+        tests::check_throws(
+            [cpu_list] { ThreadTopology::parse_cpu_list(cpu_list); });
+    }
+
+    tests::check_throws([] {
+        ThreadTopology::parse_cpu_list(std::format("{}", MAX_CPU_COUNT));
+    });
+    tests::check_throws([] {
+        ThreadTopology::parse_cpu_list(std::format("0-{}", MAX_CPU_COUNT));
+    });
+    tests::check_throws(
+        [] { ThreadTopology::parse_cpu_list("0-4294967295"); });
+}
+
+void test_format_cpu_list() {
+    tests::check(ThreadTopology::format_cpu_list({0, 1, 2, 3, 8}) == "0-3,8");
+    tests::check(ThreadTopology::format_cpu_list({4, 6}) == "4,6");
+    tests::check(ThreadTopology::format_cpu_list({}) == "any");
+}
+
+} // namespace
+
+int main() {
+    test_parse_cpu_list();
+    test_invalid_cpu_lists();
+    test_format_cpu_list();
+
+    return tests::result();
+}
@@ -0,0 +1,77 @@
+#include "check.hpp"
+#include "utils/xor_parity.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace {
+
+struct Sequence {
+    std::vector<double> numbers;
+    uint64_t checksum;
+};
+
+// The parity of a whole group, as the server sends it
+utils::XorParity get_parity(const std::vector<Sequence> &sequences) {
+    utils::XorParity parity;
+    for (const auto &sequence : sequences) {
+        parity.add(std::span<const double>{sequence.numbers},
+                   sequence.checksum);
+    }
+
+    return parity;
+}
+
+std::vector<double> to_numbers(const utils::XorParity &parity) {
+    std::vector<double> numbers(parity.number_count());
+    std::memcpy(numbers.data(), parity.bytes().data(),
+                numbers.size() * sizeof(double));
+
+    return numbers;
+}
+
+// Adding the sequences received to the parity leaves the missing one. The
+// sequences differ in length, the missing one being the shortest, the
+// longest or neither.
+void test_rebuild_missing_sequence() {
+    const std::vector<Sequence> group{{{1.5, -2.0, 3.25}, 11},
+                                      {{4.0}, 22},
+                                      {{-5.5, 6.0, 7.0, 8.0}, 33}};
+
+    for (size_t missing_index{0}; missing_index < group.size();
+         ++missing_index) {
+        auto parity = get_parity(group);
+
+        for (size_t index{0}; index < group.size(); ++index) {
+            if (index != missing_index) {
+                parity.add(std::span<const double>{group[index].numbers},
+                           group[index].checksum);
+            }
+        }
+
+        const auto &missing = group[missing_index];
+        tests::check(parity.number_count() == missing.numbers.size());
+        tests::check(parity.checksum() == missing.checksum);
+        tests::check(to_numbers(parity) == missing.numbers);
+    }
+}
+
+void test_clear() {
+    auto parity = get_parity({{{1.0, 2.0}, 5}});
+    parity.clear();
+
+    tests::check(parity.bytes().empty());
+    tests::check(parity.number_count() == 0);
+    tests::check(parity.checksum() == 0);
+}
+
+} // namespace
+
+int main() {
+    test_rebuild_missing_sequence();
+    test_clear();
+
+    return tests::result();
+}